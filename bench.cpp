@@ -0,0 +1,88 @@
+#include "bench.h"
+#include "engine.h"
+#include "engine2.h"
+#include "positions.h"
+#include "search.h"
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+struct BenchRun {
+    const char* engineName;
+    const char* fen;
+    SearchResult result;
+    double elapsedMs;
+};
+
+static void writeBenchJson(const BenchOptions& options, const std::vector<BenchRun>& runs, uint64_t nodes, double elapsedMs) {
+    std::ofstream out(options.jsonPath);
+    if (!out) {
+        std::cerr << "Failed to write bench results to " << options.jsonPath << std::endl;
+        return;
+    }
+    out << "{\n"
+        << "  \"depth\": " << options.depth << ",\n"
+        << "  \"hash_mb\": " << options.hashMb << ",\n"
+        << "  \"nodes\": " << nodes << ",\n"
+        << "  \"time_ms\": " << (uint64_t)elapsedMs << ",\n"
+        << "  \"nps\": " << (elapsedMs > 0 ? (uint64_t)(nodes * 1000 / elapsedMs) : 0) << ",\n"
+        << "  \"positions\": [\n";
+    for (size_t i = 0; i < runs.size(); i++) {
+        const BenchRun& run = runs[i];
+        out << "    {\"engine\": \"" << run.engineName << "\", \"fen\": \"" << run.fen
+            << "\", \"nodes\": " << run.result.nodes << ", \"time_ms\": " << (uint64_t)run.elapsedMs
+            << ", \"bestmove\": \"" << moveToString(run.result.bestMove) << "\", \"score\": " << run.result.score
+            << "}" << (i + 1 < runs.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+uint64_t runBench(const BenchOptions& options) {
+    struct BenchEngine {
+        const char* name;
+        RootSearch search;
+    };
+    const BenchEngine engines[] = { { "engine1", engine }, { "engine2", perft2 } };
+
+    std::vector<const char*> fens(std::begin(fenArrayShort), std::end(fenArrayShort));
+    fens.insert(fens.end(), std::begin(fenArray), std::end(fenArray));
+
+    initializeZobristTable();
+    initializeBitbases();
+    SearchLimits limits;
+    limits.depth = options.depth;
+
+    std::vector<BenchRun> runs;
+    uint64_t nodes = 0;
+    double elapsedMs = 0;
+    for (const BenchEngine& benchEngine : engines) {
+        for (size_t i = 0; i < fens.size(); i++) {
+            Board board;
+            board.createBoardFromFEN(fens[i]);
+            board.configureTranspositionTableSize(options.hashMb);
+
+            auto startTime = std::chrono::steady_clock::now();
+            SearchResult result = lazySmpSearch(board, benchEngine.search, 1, limits);
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+
+            std::cout << benchEngine.name << " position " << (i + 1) << "/" << fens.size()
+                << " bestmove " << moveToString(result.bestMove) << " score " << result.score
+                << " nodes " << result.nodes << std::endl;
+            runs.push_back({ benchEngine.name, fens[i], result, ms });
+            nodes += result.nodes;
+            elapsedMs += ms;
+        }
+    }
+
+    std::cout << "===========================" << std::endl
+        << "Total time (ms) : " << (uint64_t)elapsedMs << std::endl
+        << "Nodes searched  : " << nodes << std::endl
+        << "Nodes/second    : " << (elapsedMs > 0 ? (uint64_t)(nodes * 1000 / elapsedMs) : 0) << std::endl;
+
+    if (!options.jsonPath.empty()) {
+        writeBenchJson(options, runs, nodes, elapsedMs);
+    }
+    return nodes;
+}
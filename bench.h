@@ -0,0 +1,24 @@
+#pragma once
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <cstdint>
+#include <string>
+
+// Fixed, reproducible workload for checking changes: both engines search every
+// position in fenArrayShort and fenArray to the same depth on one thread, each
+// with a freshly cleared table of the same size. The total node count, of
+// nodes and quiescence nodes as counted by Board::nodes, is a signature of
+// the search, a change that should not alter the search (a
+// speedup, a refactoring) must leave it unchanged. Time and nodes per second
+// measure the speed.
+struct BenchOptions {
+    int depth = 6;
+    int hashMb = 16;
+    std::string jsonPath;   // Also write the results here as JSON, if set
+};
+
+// Prints one line per search and the totals, returns the total node count
+uint64_t runBench(const BenchOptions& options);
+
+#endif // BENCH_H
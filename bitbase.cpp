@@ -0,0 +1,296 @@
+#include "bitbase.h"
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+enum BitbasePiece { BITBASE_PAWN, BITBASE_ROOK, BITBASE_QUEEN, BITBASE_PIECES };
+
+// The tables are stored with the side that has the piece as white, so its
+// pawn moves up the board. Black's positions are looked up flipped.
+const int SQUARES = 64;
+const int ENTRIES = 2 * SQUARES * SQUARES * SQUARES;
+
+// Entry values: 0 is a draw, n > 0 a mate in n plies for the side to move and
+// -(n + 1) being mated in n plies, so a position that is mate already is -1
+const int8_t INVALID = -128;
+
+// More than any position can have: a queen has at most 27 moves, a king 8
+const int MAX_SUCCESSORS = 40;
+
+int indexOf(int weakToMove, int strongKing, int weakKing, int piece) {
+    return ((weakToMove * SQUARES + strongKing) * SQUARES + weakKing) * SQUARES + piece;
+}
+
+bool adjacent(int a, int b) {
+    return a != b && std::abs(a / 8 - b / 8) <= 1 && std::abs(a % 8 - b % 8) <= 1;
+}
+
+// Whether a rook or queen move from from to to is open, only blocker can be in between
+bool slides(int from, int to, int blocker, bool straight, bool diagonal) {
+    int dr = to / 8 - from / 8;
+    int dc = to % 8 - from % 8;
+    if (from == to || !((straight && (dr == 0 || dc == 0)) || (diagonal && std::abs(dr) == std::abs(dc)))) {
+        return false;
+    }
+    int step = (dr > 0 ? 8 : dr < 0 ? -8 : 0) + (dc > 0 ? 1 : dc < 0 ? -1 : 0);
+    for (int sq = from + step; sq != to; sq += step) {
+        if (sq == blocker) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool attacks(int type, int piece, int target, int blocker) {
+    switch (type) {
+    case BITBASE_PAWN:
+        return target / 8 == piece / 8 + 1 && std::abs(target % 8 - piece % 8) == 1;
+    case BITBASE_ROOK:
+        return slides(piece, target, blocker, true, false);
+    default:
+        return slides(piece, target, blocker, true, true);
+    }
+}
+
+class Bitbases {
+public:
+    Bitbases() {
+        for (int sq = 0; sq < SQUARES; sq++) {
+            kingStepCount[sq] = 0;
+            for (int target = 0; target < SQUARES; target++) {
+                if (adjacent(sq, target)) {
+                    kingSteps[sq][kingStepCount[sq]++] = target;
+                }
+            }
+        }
+
+        // KPK promotes into the other two, so they have to be complete first
+        generate(BITBASE_QUEEN);
+        generate(BITBASE_ROOK);
+        generate(BITBASE_PAWN);
+    }
+
+    int8_t probe(int type, int index) const { return tables[type][index]; }
+
+private:
+    std::vector<int8_t> tables[BITBASE_PIECES];
+    int kingSteps[SQUARES][8];
+    int kingStepCount[SQUARES];
+
+    bool valid(int type, int weakToMove, int strongKing, int weakKing, int piece) const {
+        if (strongKing == weakKing || piece == strongKing || piece == weakKing || adjacent(strongKing, weakKing)) {
+            return false;
+        }
+        if (type == BITBASE_PAWN && (piece / 8 == 0 || piece / 8 == 7)) {
+            return false;
+        }
+        // The side that just moved cannot have left the weak king in check
+        return weakToMove || !attacks(type, piece, weakKing, strongKing);
+    }
+
+    // Fills values with the entries of every position reachable in one legal
+    // move, returns how many there are. Captures and promotions to a minor
+    // piece end in a draw, promotions to a queen or rook look up that table.
+    int successors(int type, int weakToMove, int strongKing, int weakKing, int piece, int8_t* values) const {
+        int count = 0;
+        const std::vector<int8_t>& table = tables[type];
+
+        if (weakToMove) {
+            for (int i = 0; i < kingStepCount[weakKing]; i++) {
+                int sq = kingSteps[weakKing][i];
+                if (adjacent(strongKing, sq)) {
+                    continue;
+                }
+                if (sq == piece) {
+                    values[count++] = 0;
+                }
+                else if (!attacks(type, piece, sq, strongKing)) {
+                    values[count++] = table[indexOf(0, strongKing, sq, piece)];
+                }
+            }
+            return count;
+        }
+
+        for (int i = 0; i < kingStepCount[strongKing]; i++) {
+            int sq = kingSteps[strongKing][i];
+            if (sq != piece && !adjacent(weakKing, sq)) {
+                values[count++] = table[indexOf(1, sq, weakKing, piece)];
+            }
+        }
+
+        if (type != BITBASE_PAWN) {
+            static const int directions[8][2] = { {1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {1, -1}, {-1, 1}, {-1, -1} };
+            for (int d = 0; d < (type == BITBASE_QUEEN ? 8 : 4); d++) {
+                int rank = piece / 8 + directions[d][0];
+                int file = piece % 8 + directions[d][1];
+                for (; rank >= 0 && rank < 8 && file >= 0 && file < 8; rank += directions[d][0], file += directions[d][1]) {
+                    int sq = rank * 8 + file;
+                    if (sq == strongKing || sq == weakKing) {
+                        break;
+                    }
+                    values[count++] = table[indexOf(1, strongKing, weakKing, sq)];
+                }
+            }
+            return count;
+        }
+
+        int push = piece + 8;
+        if (push == strongKing || push == weakKing) {
+            return count;
+        }
+        if (push / 8 == 7) {
+            values[count++] = tables[BITBASE_QUEEN][indexOf(1, strongKing, weakKing, push)];
+            values[count++] = tables[BITBASE_ROOK][indexOf(1, strongKing, weakKing, push)];
+            values[count++] = 0;
+            return count;
+        }
+        values[count++] = table[indexOf(1, strongKing, weakKing, push)];
+        int doublePush = push + 8;
+        if (piece / 8 == 1 && doublePush != strongKing && doublePush != weakKing) {
+            values[count++] = table[indexOf(1, strongKing, weakKing, doublePush)];
+        }
+        return count;
+    }
+
+    void generate(int type) {
+        std::vector<int8_t>& table = tables[type];
+        table.assign(ENTRIES, INVALID);
+        int8_t values[MAX_SUCCESSORS];
+
+        // Mates and stalemates first, everything else is left to the passes
+        std::vector<int> open;
+        for (int index = 0; index < ENTRIES; index++) {
+            int piece = index % SQUARES;
+            int weakKing = index / SQUARES % SQUARES;
+            int strongKing = index / (SQUARES * SQUARES) % SQUARES;
+            int weakToMove = index / (SQUARES * SQUARES * SQUARES);
+            if (valid(type, weakToMove, strongKing, weakKing, piece)) {
+                table[index] = 0;
+                open.push_back(index);
+            }
+        }
+        std::vector<int> unresolved;
+        for (int index : open) {
+            int piece = index % SQUARES;
+            int weakKing = index / SQUARES % SQUARES;
+            int strongKing = index / (SQUARES * SQUARES) % SQUARES;
+            int weakToMove = index / (SQUARES * SQUARES * SQUARES);
+            if (successors(type, weakToMove, strongKing, weakKing, piece, values) > 0) {
+                unresolved.push_back(index);
+            }
+            else if (weakToMove && attacks(type, piece, weakKing, strongKing)) {
+                table[index] = -1;
+            }
+        }
+
+        // KPK positions can also be won by promoting into a position of the
+        // other tables, at any distance those have
+        int importedPlies = 0;
+        if (type == BITBASE_PAWN) {
+            for (int other : { BITBASE_QUEEN, BITBASE_ROOK }) {
+                for (int8_t value : tables[other]) {
+                    if (value != INVALID) {
+                        importedPlies = std::max(importedPlies, std::abs((int)value));
+                    }
+                }
+            }
+        }
+
+        // Pass n finds the wins in n plies when n is odd and the losses in n
+        // plies when it is even. Once a pass finds nothing and there is
+        // nothing left to import, the next one has nothing new to build on.
+        for (int plies = 1; !unresolved.empty() && plies < -INVALID - 1; plies++) {
+            bool winPass = plies % 2 == 1;
+            size_t kept = 0;
+            for (int index : unresolved) {
+                int piece = index % SQUARES;
+                int weakKing = index / SQUARES % SQUARES;
+                int strongKing = index / (SQUARES * SQUARES) % SQUARES;
+                int weakToMove = index / (SQUARES * SQUARES * SQUARES);
+                // The lone king can never win and the side with the piece never lose
+                if ((weakToMove != 0) == winPass) {
+                    unresolved[kept++] = index;
+                    continue;
+                }
+                int count = successors(type, weakToMove, strongKing, weakKing, piece, values);
+
+                bool resolved = !winPass;
+                for (int i = 0; i < count; i++) {
+                    if (winPass && values[i] == -plies) {
+                        resolved = true;
+                        break;
+                    }
+                    if (!winPass && values[i] <= 0) {
+                        resolved = false;
+                        break;
+                    }
+                }
+                if (resolved) {
+                    table[index] = (int8_t)(winPass ? plies : -(plies + 1));
+                }
+                else {
+                    unresolved[kept++] = index;
+                }
+            }
+            if (kept == unresolved.size() && plies > importedPlies) {
+                break;
+            }
+            unresolved.resize(kept);
+        }
+    }
+};
+
+const Bitbases& bitbases() {
+    static const Bitbases instance;
+    return instance;
+}
+
+}
+
+void initializeBitbases() {
+    bitbases();
+}
+
+bool probeBitbase(const Board& board, int ply, Score& score) {
+    if (std::_Popcount(board.whitePieces | board.blackPieces) != 3) {
+        return false;
+    }
+
+    bool whiteStrong = std::_Popcount(board.whitePieces) == 2;
+    Bitboard piece = whiteStrong ? board.whitePieces & ~board.whiteKing : board.blackPieces & ~board.blackKing;
+    int type;
+    if (piece & (board.whitePawns | board.blackPawns)) {
+        type = BITBASE_PAWN;
+    }
+    else if (piece & (board.whiteRooks | board.blackRooks)) {
+        type = BITBASE_ROOK;
+    }
+    else if (piece & (board.whiteQueens | board.blackQueens)) {
+        type = BITBASE_QUEEN;
+    }
+    else {
+        return false;
+    }
+
+    int strongKing = ctzll(whiteStrong ? board.whiteKing : board.blackKing);
+    int weakKing = ctzll(whiteStrong ? board.blackKing : board.whiteKing);
+    int pieceSquare = ctzll(piece);
+    if (!whiteStrong) {
+        strongKing ^= 56;
+        weakKing ^= 56;
+        pieceSquare ^= 56;
+    }
+
+    int8_t value = bitbases().probe(type, indexOf(board.whiteToMove != whiteStrong, strongKing, weakKing, pieceSquare));
+    if (value == INVALID) {
+        return false;
+    }
+    int plies = value > 0 ? value : -value - 1;
+    if (value != 0 && ply + plies >= MAX_PLY) {
+        return false;
+    }
+    score = value == 0 ? SCORE_DRAW : value > 0 ? mateIn(ply + plies) : matedIn(ply + plies);
+    return true;
+}
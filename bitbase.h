@@ -0,0 +1,25 @@
+#pragma once
+#ifndef BITBASE_H
+#define BITBASE_H
+
+#include "chess.h"
+
+// Exact results for king and pawn, rook or queen against a lone king, built
+// by retrograde analysis: starting from the mates, each pass resolves the
+// positions one ply further from mate, until no more can be resolved and the
+// rest are draws. Every position stores its distance to mate in one byte
+// rather than a single win/draw bit, so the search can tell a mate in 3 from a
+// mate in 20 and makes progress instead of shuffling in a won position. KPK
+// wins are counted through promotion to a queen or rook, so the three tables
+// together take about 1.5MB.
+
+// Builds the tables if they are not built yet, takes about a second. Called at
+// startup so the first search that reaches such an endgame does not wait.
+void initializeBitbases();
+
+// If the board holds only the two kings and one pawn, rook or queen, sets
+// score to the exact result for the side to move, ply plies from the root,
+// and returns true. Mate scores count the remaining distance to mate.
+bool probeBitbase(const Board& board, int ply, Score& score);
+
+#endif // BITBASE_H
@@ -0,0 +1,94 @@
+#include "book.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+static const char BOOK_MAGIC[4] = { 'E', 'C', 'B', 'K' };
+
+bool OpeningBook::open(const std::string& path) {
+    entries = nullptr;
+    count = 0;
+    if (!file.open(path)) {
+        return false;
+    }
+
+    if (file.size() < sizeof(BookHeader)) {
+        std::cerr << "Opening book is truncated: " << path << std::endl;
+        file.close();
+        return false;
+    }
+
+    BookHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (std::memcmp(header.magic, BOOK_MAGIC, sizeof(BOOK_MAGIC)) != 0 || header.version != VERSION) {
+        std::cerr << "Unsupported opening book format: " << path << std::endl;
+        file.close();
+        return false;
+    }
+    if (header.entryCount > (file.size() - sizeof(BookHeader)) / sizeof(BookEntry)) {
+        std::cerr << "Opening book is truncated: " << path << std::endl;
+        file.close();
+        return false;
+    }
+
+    entries = reinterpret_cast<const BookEntry*>(file.data() + sizeof(BookHeader));
+    count = static_cast<size_t>(header.entryCount);
+    return true;
+}
+
+std::vector<BookEntry> OpeningBook::probe(uint64_t key) const {
+    std::vector<BookEntry> moves;
+    if (!entries) {
+        return moves;
+    }
+
+    const BookEntry* first = std::lower_bound(entries, entries + count, key, [](const BookEntry& entry, uint64_t k) {
+        return entry.key < k;
+        });
+    for (const BookEntry* it = first; it != entries + count && it->key == key; ++it) {
+        moves.push_back(*it);
+    }
+
+    std::stable_sort(moves.begin(), moves.end(), [](const BookEntry& a, const BookEntry& b) {
+        return a.weight > b.weight;
+        });
+    return moves;
+}
+
+bool OpeningBook::write(const std::string& path, std::vector<BookEntry> bookEntries) {
+    auto sameMove = [](const BookEntry& a, const BookEntry& b) {
+        return a.key == b.key && a.from == b.from && a.to == b.to && a.promotion == b.promotion;
+        };
+    std::sort(bookEntries.begin(), bookEntries.end(), [](const BookEntry& a, const BookEntry& b) {
+        if (a.key != b.key) return a.key < b.key;
+        if (a.from != b.from) return a.from < b.from;
+        if (a.to != b.to) return a.to < b.to;
+        return a.promotion < b.promotion;
+        });
+
+    // Merge repeated moves so each (position, move) pair appears once
+    std::vector<BookEntry> merged;
+    for (const BookEntry& entry : bookEntries) {
+        if (!merged.empty() && sameMove(merged.back(), entry)) {
+            merged.back().weight += entry.weight;
+        }
+        else {
+            merged.push_back(entry);
+        }
+    }
+
+    std::ofstream out(path, std::ios::binary);
+    if (!out) {
+        std::cerr << "Failed to open file for writing: " << path << std::endl;
+        return false;
+    }
+
+    BookHeader header;
+    std::memcpy(header.magic, BOOK_MAGIC, sizeof(BOOK_MAGIC));
+    header.version = VERSION;
+    header.entryCount = merged.size();
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(merged.data()), merged.size() * sizeof(BookEntry));
+    return static_cast<bool>(out);
+}
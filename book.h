@@ -0,0 +1,58 @@
+#pragma once
+#ifndef BOOK_H
+#define BOOK_H
+
+#include "mappedfile.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#define OPENING_BOOK_FILE "opening_book.bin"
+
+// One book move as stored on disk. Entries are sorted by key so that all moves
+// for a position are adjacent and can be found with a binary search.
+struct BookEntry {
+    uint64_t key;       // Zobrist key of the position the move is played from
+    uint8_t from;
+    uint8_t to;
+    char promotion;
+    uint8_t isCapture;
+    uint32_t weight;    // Number of games in which the move was played
+};
+static_assert(sizeof(BookEntry) == 16, "BookEntry must stay packed, it is mapped straight from disk");
+
+struct BookHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t entryCount;
+};
+static_assert(sizeof(BookHeader) == 16, "BookHeader must stay packed, it is mapped straight from disk");
+
+// Immutable key->moves index backed by a memory-mapped file. It is kept apart
+// from the transposition table so that search results can never evict book
+// moves and book moves never take slots away from the search.
+class OpeningBook {
+public:
+    static const uint32_t VERSION = 1;
+
+    OpeningBook() = default;
+    explicit OpeningBook(const std::string& path) { open(path); }
+
+    bool open(const std::string& path);
+    bool isOpen() const { return entries != nullptr; }
+    size_t size() const { return count; }
+
+    // Returns every book move for the position, most played first.
+    std::vector<BookEntry> probe(uint64_t key) const;
+
+    // Sorts and merges the entries (summing weights of duplicates) and writes
+    // them in the format read by open().
+    static bool write(const std::string& path, std::vector<BookEntry> entries);
+
+private:
+    MappedFile file;
+    const BookEntry* entries = nullptr;
+    size_t count = 0;
+};
+
+#endif // BOOK_H
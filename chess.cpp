@@ -5,6 +5,10 @@
 #include <intrin.h>
 #include <chrono>
 #include "zobrist.h"
+#include "book.h"
+#include "searchcontrol.h"
+#include <cstring>
+#include <cctype>
 
 const Move NO_MOVE;
 
@@ -37,51 +41,12 @@ unsigned int ctzll(unsigned long long x) {
 #endif
 }
 
-/**
-// Function to serialize a Move object
-std::ostream& operator<<(std::ostream& os, const Move& move) {
-    os.write(reinterpret_cast<const char*>(&move.from), sizeof(move.from));
-    os.write(reinterpret_cast<const char*>(&move.to), sizeof(move.to));
-    os.write(reinterpret_cast<const char*>(&move.promotion), sizeof(move.promotion));
-    os.write(reinterpret_cast<const char*>(&move.isCapture), sizeof(move.isCapture));
-    os.write(reinterpret_cast<const char*>(&move.capturedPiece), sizeof(move.capturedPiece));
-    return os;
-}
-
-// Function to deserialize a Move object
-std::istream& operator>>(std::istream& is, Move& move) {
-    is.read(reinterpret_cast<char*>(&move.from), sizeof(move.from));
-    is.read(reinterpret_cast<char*>(&move.to), sizeof(move.to));
-    is.read(reinterpret_cast<char*>(&move.promotion), sizeof(move.promotion));
-    is.read(reinterpret_cast<char*>(&move.isCapture), sizeof(move.isCapture));
-    is.read(reinterpret_cast<char*>(&move.capturedPiece), sizeof(move.capturedPiece));
-    return is;
-}
-
-// Function to serialize a TT_Entry object
-std::ostream& operator<<(std::ostream& os, const TT_Entry& entry) {
-    os.write(reinterpret_cast<const char*>(&entry.key), sizeof(entry.key));
-    os.write(reinterpret_cast<const char*>(&entry.score), sizeof(entry.score));
-    os.write(reinterpret_cast<const char*>(&entry.depth), sizeof(entry.depth));
-    os.write(reinterpret_cast<const char*>(&entry.flag), sizeof(entry.flag));
-    os << entry.move;
-    return os;
-}
-
-// Function to deserialize a TT_Entry object
-std::istream& operator>>(std::istream& is, TT_Entry& entry) {
-    is.read(reinterpret_cast<char*>(&entry.key), sizeof(entry.key));
-    is.read(reinterpret_cast<char*>(&entry.score), sizeof(entry.score));
-    is.read(reinterpret_cast<char*>(&entry.depth), sizeof(entry.depth));
-    is.read(reinterpret_cast<char*>(&entry.flag), sizeof(entry.flag));
-    is >> entry.move;
-    return is;
-}
-*/
 // Constructor to initialize the board
 Board::Board() {
+    searchControl = &::searchControl;
     createBoard();
     initializeZobristTable();
+    transposition_table = std::make_shared<std::vector<TT_Entry>>();
     resize_tt(64);  // Calls the resize function to allocate memory
     clear_tt();     // Clear the table to reset all entries
     loadOpeningBook();
@@ -716,6 +681,7 @@ void Board::makeMove(Move& move) {
             }
             else if (enPassantTarget & toMask) {
                 blackPawns &= ~(toMask >> 8);
+                move.capturedPiece = 'p';
             }
         }
         whitePieces = whitePawns | whiteRooks | whiteKnights | whiteBishops | whiteQueens | whiteKing;
@@ -791,6 +757,7 @@ void Board::makeMove(Move& move) {
             }
             else if (enPassantTarget & toMask) {
                 whitePawns &= ~(toMask << 8);
+                move.capturedPiece = 'p';
             }
         }
         whitePieces = whitePawns | whiteRooks | whiteKnights | whiteBishops | whiteQueens | whiteKing;
@@ -867,20 +834,20 @@ void Board::undoMove(const Move& move) {
 
         // Handle captures
         if (move.isCapture) {
-            // Restore the pawn for en passant captures
-            if ((move.to == move.from + 9 || move.to == move.from + 7)) {
-                if (toMask & enPassantTarget) {
-                    blackPawns |= toMask >> 8;
-                }
+            // Restore the pawn for en passant captures, behind the target
+            // square rather than on it like any other captured piece
+            if ((move.to == move.from + 9 || move.to == move.from + 7) && (toMask & enPassantTarget)) {
+                blackPawns |= toMask >> 8;
             }
-
-            switch (move.capturedPiece) {
-            case 'p': blackPawns |= toMask; break;
-            case 'r': blackRooks |= toMask; break;
-            case 'n': blackKnights |= toMask; break;
-            case 'b': blackBishops |= toMask; break;
-            case 'q': blackQueens |= toMask; break;
-            case 'k': blackKing |= toMask; break;
+            else {
+                switch (move.capturedPiece) {
+                case 'p': blackPawns |= toMask; break;
+                case 'r': blackRooks |= toMask; break;
+                case 'n': blackKnights |= toMask; break;
+                case 'b': blackBishops |= toMask; break;
+                case 'q': blackQueens |= toMask; break;
+                case 'k': blackKing |= toMask; break;
+                }
             }
         }
     }
@@ -922,20 +889,20 @@ void Board::undoMove(const Move& move) {
 
         // Handle captures
         if (move.isCapture) {
-            // Restore the pawn for en passant captures
-            if ((move.to == move.from - 9 || move.to == move.from - 7)) {
-                if (toMask & enPassantTarget) {
-                    whitePawns |= toMask << 8;
-                }
+            // Restore the pawn for en passant captures, behind the target
+            // square rather than on it like any other captured piece
+            if ((move.to == move.from - 9 || move.to == move.from - 7) && (toMask & enPassantTarget)) {
+                whitePawns |= toMask << 8;
             }
-
-            switch (move.capturedPiece) {
-            case 'p': whitePawns |= toMask; break;
-            case 'r': whiteRooks |= toMask; break;
-            case 'n': whiteKnights |= toMask; break;
-            case 'b': whiteBishops |= toMask; break;
-            case 'q': whiteQueens |= toMask; break;
-            case 'k': whiteKing |= toMask; break;
+            else {
+                switch (move.capturedPiece) {
+                case 'p': whitePawns |= toMask; break;
+                case 'r': whiteRooks |= toMask; break;
+                case 'n': whiteKnights |= toMask; break;
+                case 'b': whiteBishops |= toMask; break;
+                case 'q': whiteQueens |= toMask; break;
+                case 'k': whiteKing |= toMask; break;
+                }
             }
         }
     }
@@ -1184,90 +1151,294 @@ int getPieceValue(char piece) {
     }
 }
 
-bool isGoodCapture(const Move& move, const Board& board) {
-    char attackerPiece = board.getPieceAt(move.from);
-    char defenderPiece = move.capturedPiece;
-
-    int attackerValue = getPieceValue(attackerPiece);
-    int defenderValue = getPieceValue(defenderPiece);
+// Knight and king attack sets, filled the first time attackersTo needs them
+struct LeaperAttacks {
+    Bitboard knight[64];
+    Bitboard king[64];
+
+    LeaperAttacks() {
+        const int knightMoves[8] = { 17, 15, 10, 6, -17, -15, -10, -6 };
+        const int kingMoves[8] = { 8, -8, 1, -1, 9, 7, -9, -7 };
+        for (int square = 0; square < 64; square++) {
+            knight[square] = 0;
+            king[square] = 0;
+            for (int i = 0; i < 8; i++) {
+                int to = square + knightMoves[i];
+                if (to >= 0 && to < 64 && abs(square % 8 - to % 8) <= 2) {
+                    knight[square] |= 1ULL << to;
+                }
+                to = square + kingMoves[i];
+                if (to >= 0 && to < 64 && abs(square % 8 - to % 8) <= 1) {
+                    king[square] |= 1ULL << to;
+                }
+            }
+        }
+    }
+};
 
-    return defenderValue > attackerValue;
+static const LeaperAttacks& leaperAttacks() {
+    static const LeaperAttacks attacks;
+    return attacks;
 }
 
-bool isEqualCapture(const Move& move, const Board& board) {
-    char attackerPiece = board.getPieceAt(move.from);
-    char defenderPiece = move.capturedPiece;
-
-    int attackerValue = getPieceValue(attackerPiece);
-    int defenderValue = getPieceValue(defenderPiece);
-
-    return defenderValue == attackerValue;
+// Squares a slider on square reaches along the given directions, stopping at
+// the first occupied square
+static Bitboard slidingAttacks(int square, Bitboard occupied, const int directions[4]) {
+    Bitboard attacks = 0;
+    for (int i = 0; i < 4; i++) {
+        int from = square;
+        while (true) {
+            int to = from + directions[i];
+            // A step that changes the file by more than one wrapped around the board edge
+            if (to < 0 || to >= 64 || abs(from % 8 - to % 8) > 1) break;
+            attacks |= 1ULL << to;
+            if (occupied & (1ULL << to)) break;
+            from = to;
+        }
+    }
+    return attacks;
 }
 
-bool isKillerMove(const Move& move, const Board& board, int depth) {
-    return (move == board.killerMoves[0][depth] || move == board.killerMoves[1][depth]);
- }
-
-std::vector<Move> orderMoves(Board & board, const std::vector<Move>&moves, TT_Entry * ttEntry, int depth) {
-    Move hashMove = (ttEntry && ttEntry->depth >= depth && ttEntry->flag == HASH_FLAG_EXACT) ? ttEntry->move : NO_MOVE;
-    Move shallowHashMove = (ttEntry && ttEntry->depth >= (depth - 2) && ttEntry->flag == HASH_FLAG_EXACT) ? ttEntry->move : NO_MOVE;
-    std::vector<Move> orderedMoves;
-    std::vector<Move> hashMoves;
-    std::vector<Move> capturesAndPromotions;
-    std::vector<Move> promotions;
-    std::vector<Move> goodCaptures;
-    std::vector<Move> equalCaptures;
-    std::vector<Move> killerMoves;
-    std::vector<Move> nonCaptures;
-    std::vector<Move> losingCaptures;
+static const int DIAGONAL_DIRECTIONS[4] = { 9, 7, -9, -7 };
+static const int STRAIGHT_DIRECTIONS[4] = { 8, -8, 1, -1 };
+
+Bitboard Board::attackersTo(int square, Bitboard occupied) const {
+    Bitboard target = 1ULL << square;
+    // White pawns capture towards higher squares, black pawns towards lower ones
+    Bitboard pawnAttackers = ((((target & 0x7F7F7F7F7F7F7F7F) >> 7) | ((target & 0xFEFEFEFEFEFEFEFE) >> 9)) & whitePawns)
+        | ((((target & 0xFEFEFEFEFEFEFEFE) << 7) | ((target & 0x7F7F7F7F7F7F7F7F) << 9)) & blackPawns);
+    Bitboard diagonalSliders = whiteBishops | blackBishops | whiteQueens | blackQueens;
+    Bitboard straightSliders = whiteRooks | blackRooks | whiteQueens | blackQueens;
+
+    return (pawnAttackers
+        | (leaperAttacks().knight[square] & (whiteKnights | blackKnights))
+        | (leaperAttacks().king[square] & (whiteKing | blackKing))
+        | (slidingAttacks(square, occupied, DIAGONAL_DIRECTIONS) & diagonalSliders)
+        | (slidingAttacks(square, occupied, STRAIGHT_DIRECTIONS) & straightSliders)) & occupied;
+}
 
-    for (const Move& move : moves) {
-        // Assuming you have a function isIterativeDeepeningMove to check if the move is an iterative deepening move
-        if (move == hashMove) {
-            hashMoves.push_back(move);
+std::vector<Move> Board::generateCaptures() const {
+    std::vector<Move> moves;
+    Bitboard ownPieces = whiteToMove ? whitePieces : blackPieces;
+    Bitboard opponentPieces = whiteToMove ? blackPieces : whitePieces;
+    Bitboard occupied = whitePieces | blackPieces;
+    Bitboard promotionRank = whiteToMove ? 0xFF00000000000000 : 0x00000000000000FF;
+    Bitboard pawns = whiteToMove ? whitePawns : blackPawns;
+
+    // Pawn captures, the only captures that can land on the en passant square
+    Bitboard leftCaptures = whiteToMove ? (pawns << 9) & 0xFEFEFEFEFEFEFEFE : (pawns >> 9) & 0x7F7F7F7F7F7F7F7F;
+    Bitboard rightCaptures = whiteToMove ? (pawns << 7) & 0x7F7F7F7F7F7F7F7F : (pawns >> 7) & 0xFEFEFEFEFEFEFEFE;
+    Bitboard pawnTargets[2] = { leftCaptures & (opponentPieces | enPassantTarget), rightCaptures & (opponentPieces | enPassantTarget) };
+    const int pawnShifts[2] = { 9, 7 };
+    for (int side = 0; side < 2; side++) {
+        while (pawnTargets[side]) {
+            int to = ctzll(pawnTargets[side]);
+            pawnTargets[side] &= pawnTargets[side] - 1;
+            Move move(whiteToMove ? to - pawnShifts[side] : to + pawnShifts[side], to, ((1ULL << to) & promotionRank) ? 'q' : 0);
+            move.isCapture = true;
+            move.capturedPiece = (opponentPieces & (1ULL << to)) ? (char)tolower(getPieceAt(to)) : 'p';
+            moves.push_back(move);
         }
-        else if (move == shallowHashMove) {
-            hashMoves.push_back(move);
+    }
+
+    // Pushes onto the last rank
+    Bitboard promotions = (whiteToMove ? pawns << 8 : pawns >> 8) & ~occupied & promotionRank;
+    while (promotions) {
+        int to = ctzll(promotions);
+        promotions &= promotions - 1;
+        moves.emplace_back(whiteToMove ? to - 8 : to + 8, to, 'q');
+    }
+
+    Bitboard knights = whiteToMove ? whiteKnights : blackKnights;
+    Bitboard diagonalSliders = whiteToMove ? whiteBishops | whiteQueens : blackBishops | blackQueens;
+    Bitboard straightSliders = whiteToMove ? whiteRooks | whiteQueens : blackRooks | blackQueens;
+    Bitboard pieces = ownPieces & ~pawns;
+    while (pieces) {
+        int from = ctzll(pieces);
+        pieces &= pieces - 1;
+        Bitboard fromMask = 1ULL << from;
+        Bitboard targets = 0;
+        if (knights & fromMask) {
+            targets = leaperAttacks().knight[from];
         }
-        else if (move.isCapture || move.promotion) {
-            capturesAndPromotions.push_back(move);
+        else if ((whiteToMove ? whiteKing : blackKing) & fromMask) {
+            targets = leaperAttacks().king[from];
         }
-        else if (move.promotion) {
-            promotions.push_back(move);
+        else {
+            if (diagonalSliders & fromMask) {
+                targets |= slidingAttacks(from, occupied, DIAGONAL_DIRECTIONS);
+            }
+            if (straightSliders & fromMask) {
+                targets |= slidingAttacks(from, occupied, STRAIGHT_DIRECTIONS);
+            }
         }
-        else if (isGoodCapture(move, board)) {
-            goodCaptures.push_back(move);
+        targets &= opponentPieces;
+        while (targets) {
+            int to = ctzll(targets);
+            targets &= targets - 1;
+            Move move(from, to);
+            move.isCapture = true;
+            move.capturedPiece = (char)tolower(getPieceAt(to));
+            moves.push_back(move);
         }
-        else if (isEqualCapture(move, board)) {
-            equalCaptures.push_back(move);
+    }
+    return moves;
+}
+
+// Pawn, knight, bishop, rook, queen, king, in getPieceIndex order
+static const int SEE_VALUES[6] = { 100, 300, 300, 500, 900, 20000 };
+
+static int seeValue(const Board& board, char piece) {
+    return piece == ' ' ? 0 : SEE_VALUES[board.getPieceIndex(piece) % 6];
+}
+
+int Board::see(const Move& move) const {
+    Bitboard whiteBoard[6] = { whitePawns, whiteKnights, whiteBishops, whiteRooks, whiteQueens, whiteKing };
+    Bitboard blackBoard[6] = { blackPawns, blackKnights, blackBishops, blackRooks, blackQueens, blackKing };
+    Bitboard occupied = whitePieces | blackPieces;
+    char mover = getPieceAt(move.from);
+    char victim = getPieceAt(move.to);
+    bool moverIsWhite = (whitePieces >> move.from) & 1;
+
+    int gain[32];
+    int d = 0;
+    gain[0] = seeValue(*this, victim);
+    if (victim == ' ' && move.isCapture) {
+        // En passant, the captured pawn is not on the target square
+        gain[0] = SEE_VALUES[0];
+        occupied ^= 1ULL << (moverIsWhite ? move.to - 8 : move.to + 8);
+    }
+    int onSquare = seeValue(*this, mover);
+    if (move.promotion) {
+        gain[0] += seeValue(*this, move.promotion) - SEE_VALUES[0];
+        onSquare = seeValue(*this, move.promotion);
+    }
+    occupied ^= 1ULL << move.from;
+
+    bool sideWhite = !moverIsWhite;
+    // Recomputing the attackers with the capturing pieces removed from occupied
+    // brings in the sliders lined up behind them
+    Bitboard attackers = attackersTo(move.to, occupied);
+    while (d < 31) {
+        // What the side to capture would end up with if it took the piece on the square
+        d++;
+        gain[d] = onSquare - gain[d - 1];
+        // Neither taking nor declining can change the outcome any more
+        if (std::max(-gain[d - 1], gain[d]) < 0) {
+            break;
+        }
+
+        const Bitboard* sideBoard = sideWhite ? whiteBoard : blackBoard;
+        int pieceType = -1;
+        Bitboard from = 0;
+        for (int type = 0; type < 6; type++) {
+            from = attackers & sideBoard[type];
+            if (from) {
+                pieceType = type;
+                break;
+            }
         }
-        else if (isKillerMove(move, board, depth)) {
-            killerMoves.push_back(move);
+        if (pieceType == -1) {
+            break;
         }
-        else if (!move.isCapture) {
-            nonCaptures.push_back(move);
+        // The king may only take last, while nothing defends the square
+        if (pieceType == 5 && (attackers & (sideWhite ? blackPieces : whitePieces))) {
+            break;
         }
-        else {
-            losingCaptures.push_back(move);
+
+        occupied ^= from & (~from + 1);
+        onSquare = SEE_VALUES[pieceType];
+        attackers = attackersTo(move.to, occupied);
+        sideWhite = !sideWhite;
+    }
+
+    // The last entry assumed a capture that never happened, fold the rest back
+    // from the end of the sequence with either side free to stop
+    while (--d > 0) {
+        gain[d - 1] = -std::max(-gain[d - 1], gain[d]);
+    }
+    return gain[0];
+}
+
+MoveHistory::MoveHistory()
+    : butterfly(2 * 64 * 64), counterMoves(12 * 64) {
+    continuation[0].resize(12 * 64 * 12 * 64);
+    continuation[1].resize(12 * 64 * 12 * 64);
+}
+
+void MoveHistory::clear() {
+    std::fill(butterfly.begin(), butterfly.end(), 0);
+    std::fill(counterMoves.begin(), counterMoves.end(), NO_MOVE);
+    std::fill(continuation[0].begin(), continuation[0].end(), 0);
+    std::fill(continuation[1].begin(), continuation[1].end(), 0);
+}
+
+void MoveHistory::age() {
+    for (int16_t& score : butterfly) score /= 2;
+    for (int16_t& score : continuation[0]) score /= 2;
+    for (int16_t& score : continuation[1]) score /= 2;
+}
+
+// Gravity update: the closer a score is to MAX_HISTORY the less a bonus moves
+// it, so frequently rewarded moves saturate instead of overflowing
+static void updateHistoryScore(int16_t& score, int bonus) {
+    score += bonus - score * std::abs(bonus) / MoveHistory::MAX_HISTORY;
+}
+
+void Board::recordSearchMove(int ply, const Move& move) {
+    if (ply >= MAX_PLY) {
+        return;
+    }
+    searchStack[ply].piece = move.from == -1 ? -1 : getPieceIndex(getPieceAt(move.from));
+    searchStack[ply].to = move.to;
+}
+
+int Board::quietMoveScore(const Move& move, int ply) const {
+    int score = history.butterfly[MoveHistory::butterflyIndex(whiteToMove, move.from, move.to)];
+    int piece = getPieceIndex(getPieceAt(move.from));
+    for (int back = 1; back <= 2; back++) {
+        if (ply - back >= 0 && ply - back < MAX_PLY && searchStack[ply - back].piece != -1) {
+            const SearchPly& earlier = searchStack[ply - back];
+            score += history.continuation[back - 1][MoveHistory::continuationIndex(earlier.piece, earlier.to, piece, move.to)];
         }
     }
+    return score;
+}
+
+Move Board::counterMove(int ply) const {
+    if (ply < 1 || ply > MAX_PLY || searchStack[ply - 1].piece == -1) {
+        return NO_MOVE;
+    }
+    return history.counterMoves[searchStack[ply - 1].piece * 64 + searchStack[ply - 1].to];
+}
+
+void Board::updateQuietHistory(const Move& best, const Move* quietsSearched, int quietCount, int depth, int ply) {
+    int bonus = std::min(32 * depth * depth, 2048);
 
-    // Append moves in the order of priority
-    orderedMoves.insert(orderedMoves.end(), hashMoves.begin(), hashMoves.end());
-    orderedMoves.insert(orderedMoves.end(), capturesAndPromotions.begin(), capturesAndPromotions.end());
-    orderedMoves.insert(orderedMoves.end(), promotions.begin(), promotions.end());
-    orderedMoves.insert(orderedMoves.end(), goodCaptures.begin(), goodCaptures.end());
-    orderedMoves.insert(orderedMoves.end(), equalCaptures.begin(), equalCaptures.end());
-    orderedMoves.insert(orderedMoves.end(), killerMoves.begin(), killerMoves.end());
-    orderedMoves.insert(orderedMoves.end(), nonCaptures.begin(), nonCaptures.end());
-    orderedMoves.insert(orderedMoves.end(), losingCaptures.begin(), losingCaptures.end());
+    auto update = [&](const Move& move, int amount) {
+        updateHistoryScore(history.butterfly[MoveHistory::butterflyIndex(whiteToMove, move.from, move.to)], amount);
+        int piece = getPieceIndex(getPieceAt(move.from));
+        for (int back = 1; back <= 2; back++) {
+            if (ply - back >= 0 && ply - back < MAX_PLY && searchStack[ply - back].piece != -1) {
+                const SearchPly& earlier = searchStack[ply - back];
+                updateHistoryScore(history.continuation[back - 1][MoveHistory::continuationIndex(earlier.piece, earlier.to, piece, move.to)], amount);
+            }
+        }
+        };
 
-    return orderedMoves;
+    update(best, bonus);
+    for (int i = 0; i < quietCount; i++) {
+        update(quietsSearched[i], -bonus);
+    }
+
+    if (ply >= 1 && ply <= MAX_PLY && searchStack[ply - 1].piece != -1) {
+        history.counterMoves[searchStack[ply - 1].piece * 64 + searchStack[ply - 1].to] = best;
+    }
 }
 
-bool isTacticalPosition(std::vector<Move> moves, Board board) {
+bool isTacticalPosition(const std::vector<Move>& moves, const Board& board) {
     for (const Move& move : moves) {
-        if (move.isCapture && (isGoodCapture(move, board) || isEqualCapture(move, board)) || move.promotion) {
+        if ((move.isCapture && board.see(move) >= 0) || move.promotion) {
             return true;
         }
     }
@@ -1277,7 +1448,7 @@ bool isTacticalPosition(std::vector<Move> moves, Board board) {
 void Board::resize_tt(uint64_t mb) {
     size_t entries = (mb * 1048576ull) / sizeof(TT_Entry);
     size_t new_entries = 1ull << (int)std::log2(entries);  // Ensures power of 2 size for efficient indexing
-    transposition_table.resize(new_entries);
+    transposition_table->resize(new_entries);
     clear_tt();  // Clear the table to ensure all entries are reset after resizing
 }
 
@@ -1286,21 +1457,58 @@ void Board::configureTranspositionTableSize(uint64_t sizeInMB) {
     resize_tt(sizeInMB);
 }
 
-void Board::record_tt_entry(uint64_t hash_key, int score, TTFlag flag, Move move, int depth) {
-    TT_Entry& tt_entry = transposition_table[hash_key & (transposition_table.size() - 1)];
+// XOR of the two payload words that follow the key
+static uint64_t ttEntryPayload(const TT_Entry& entry) {
+    uint64_t words[2];
+    std::memcpy(words, reinterpret_cast<const unsigned char*>(&entry) + sizeof(uint64_t), sizeof(words));
+    return words[0] ^ words[1];
+}
+
+// Copies a slot out of the shared table and decodes its key. The copy is taken
+// byte-wise so the payload checked is exactly the one returned.
+static TT_Entry loadTTEntry(const TT_Entry& slot) {
+    TT_Entry entry;
+    std::memcpy(&entry, &slot, sizeof(TT_Entry));
+    entry.key ^= ttEntryPayload(entry);
+    return entry;
+}
+
+static void storeTTEntry(TT_Entry& slot, TT_Entry entry) {
+    entry.key ^= ttEntryPayload(entry);
+    std::memcpy(&slot, &entry, sizeof(TT_Entry));
+}
 
-    // Use deeper or exact information to replace existing entry
-    if (tt_entry.key != hash_key || depth > tt_entry.depth || flag == HASH_FLAG_EXACT) {
+void Board::record_tt_entry(uint64_t hash_key, Score score, TTFlag flag, Move move, int depth) {
+    std::vector<TT_Entry>& table = *transposition_table;
+    TT_Entry& slot = table[hash_key & (table.size() - 1)];
+    TT_Entry tt_entry = loadTTEntry(slot);
+
+    // Depth preferred: a deeper entry stays until a search at least as deep
+    // replaces it, so the flood of quiescence results cannot evict the main
+    // search's entries and hash moves. Entries of an earlier search are
+    // replaced regardless, or they would fill the table for good. The same
+    // position is also updated by exact information of the same depth.
+    bool replace = tt_entry.key == hash_key
+        ? depth > tt_entry.depth || (flag == HASH_FLAG_EXACT && depth >= tt_entry.depth)
+        : depth >= tt_entry.depth || tt_entry.generation != ttGeneration;
+    if (replace) {
+        ttStats.stores++;
+        if (slot.key != 0 && tt_entry.key != hash_key) {
+            ttStats.overwrites++;
+        }
         tt_entry.key = hash_key;
-        tt_entry.score = score;
+        tt_entry.score = static_cast<int16_t>(score);
         tt_entry.flag = flag;
         tt_entry.move = move;
-        tt_entry.depth = depth;
+        tt_entry.depth = static_cast<int8_t>(depth);
+        tt_entry.generation = ttGeneration;
+        storeTTEntry(slot, tt_entry);
     }
 }
 
-short Board::probe_tt_entry(uint64_t hash_key, int alpha, int beta, int depth, TT_Entry& return_entry) {
-    TT_Entry& tt_entry = transposition_table[hash_key & (transposition_table.size() - 1)];
+short Board::probe_tt_entry(uint64_t hash_key, Score alpha, Score beta, int depth, TT_Entry& return_entry) {
+    std::vector<TT_Entry>& table = *transposition_table;
+    TT_Entry tt_entry = loadTTEntry(table[hash_key & (table.size() - 1)]);
 
     if (tt_entry.key == hash_key) {
         return_entry = tt_entry;  // Copy the found entry to return_entry
@@ -1317,13 +1525,52 @@ short Board::probe_tt_entry(uint64_t hash_key, int alpha, int beta, int depth, T
 }
 
 void Board::clear_tt() {
-    for (auto& tt_entry : transposition_table) {
+    for (auto& tt_entry : *transposition_table) {
         tt_entry = TT_Entry();  // Reset each entry
     }
 }
 
-TT_Entry* Board::probeTranspositionTable(uint64_t hash) {
-    return &transposition_table[hash % transposition_table.size()];
+// Returns a decoded copy of the slot for the position. The caller must still
+// compare the key, a different or torn entry comes back with a key that does
+// not match.
+TT_Entry Board::probeTranspositionTable(uint64_t hash) {
+    const std::vector<TT_Entry>& table = *transposition_table;
+    const TT_Entry& slot = table[hash & (table.size() - 1)];
+    TT_Entry entry = loadTTEntry(slot);
+    ttStats.probes++;
+    if (entry.key == hash) {
+        ttStats.hits++;
+    }
+    else if (slot.key != 0) {
+        ttStats.collisions++;
+    }
+    return entry;
+}
+
+void Board::recordTTCutoff(TTFlag flag) {
+    if (flag == HASH_FLAG_EXACT) {
+        ttStats.exactCutoffs++;
+    }
+    else {
+        ttStats.boundCutoffs++;
+    }
+}
+
+// Estimates table occupancy in per mille from the first 1000 slots instead of
+// scanning the whole table like countTranspositionTableEntries().
+int Board::hashfull() const {
+    const std::vector<TT_Entry>& table = *transposition_table;
+    size_t sample = std::min<size_t>(1000, table.size());
+    if (sample == 0) {
+        return 0;
+    }
+    size_t used = 0;
+    for (size_t i = 0; i < sample; ++i) {
+        if (table[i].key != 0) {
+            ++used;
+        }
+    }
+    return static_cast<int>(used * 1000 / sample);
 }
 
 bool isNullViable(Board& board) {
@@ -1345,39 +1592,34 @@ bool isNullViable(Board& board) {
     }
 }
 
-// Function to deserialize a Move object
-std::istream& operator>>(std::istream& is, Move& move) {
-    is.read(reinterpret_cast<char*>(&move.from), sizeof(move.from));
-    is.read(reinterpret_cast<char*>(&move.to), sizeof(move.to));
-    is.read(reinterpret_cast<char*>(&move.promotion), sizeof(move.promotion));
-    is.read(reinterpret_cast<char*>(&move.isCapture), sizeof(move.isCapture));
-    is.read(reinterpret_cast<char*>(&move.capturedPiece), sizeof(move.capturedPiece));
-    return is;
-}
-
-// Function to deserialize a TT_Entry object
-std::istream& operator>>(std::istream& is, TT_Entry& entry) {
-    is.read(reinterpret_cast<char*>(&entry.key), sizeof(entry.key));
-    is.read(reinterpret_cast<char*>(&entry.score), sizeof(entry.score));
-    is.read(reinterpret_cast<char*>(&entry.depth), sizeof(entry.depth));
-    is.read(reinterpret_cast<char*>(&entry.flag), sizeof(entry.flag));
-    is >> entry.move;
-    return is;
+void Board::loadOpeningBook() {
+    // The book is read-only, so every board shares the same mapping
+    // A missing book is left to the front end to report, openingBook stays null
+    static const OpeningBook book(OPENING_BOOK_FILE);
+    openingBook = book.isOpen() ? &book : nullptr;
 }
 
-void Board::loadOpeningBook() {
-    std::string filename = "transposition_table.dat";
-    std::ifstream file2(filename, std::ios::binary);
-    if (!file2) {
-        std::cerr << "Failed to open file for reading: " << filename << std::endl;
-        return;
+// Looks the current position up in the opening book. Book moves are matched
+// against the legal moves so a key collision can never return an illegal move.
+bool Board::probeOpeningBook(Move& move) {
+    if (!openingBook) {
+        return false;
+    }
+    std::vector<BookEntry> bookMoves = openingBook->probe(generateZobristHash());
+    if (bookMoves.empty()) {
+        return false;
     }
-    TT_Entry entry2;
-    while (file2 >> entry2) {
-        if (entry2.key != 0 && entry2.move.from != -1 && entry2.move.to != -1) {
-            record_tt_entry(entry2.key, 0, HASH_BOOK, entry2.move, 0);
+
+    std::vector<Move> legalMoves = generateAllMoves();
+    for (const BookEntry& entry : bookMoves) {
+        for (const Move& legalMove : legalMoves) {
+            if (legalMove.from == entry.from && legalMove.to == entry.to && legalMove.promotion == entry.promotion) {
+                move = legalMove;
+                return true;
+            }
         }
     }
+    return false;
 }
 
 // Function to convert a board position (e.g. "e2") to an index
@@ -1405,9 +1647,20 @@ Move convertToMoveObject(const std::string& moveStr) {
     return Move(from, to);
 }
 
+std::string moveToString(const Move& move) {
+    if (move.from == -1 || move.to == -1) {
+        return "0000";
+    }
+    std::string result = numToBoardPosition(move.from) + numToBoardPosition(move.to);
+    if (move.promotion) {
+        result += (char)std::tolower(move.promotion);
+    }
+    return result;
+}
+
 size_t Board::countTranspositionTableEntries() const {
     size_t count = 0;
-    for (const auto& entry : transposition_table) {
+    for (const auto& entry : *transposition_table) {
         if (entry.key != 0) {
             ++count;
         }
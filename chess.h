@@ -14,6 +14,7 @@
 #include <tuple>
 #include <fstream>
 #include <sstream>
+#include <memory>
 #include <unordered_map>
 #include <vector>
 #include <algorithm>
@@ -25,6 +26,46 @@ typedef uint64_t Bitboard;
 #define USE_HASH_MOVE       1
 #define RETURN_HASH_SCORE   2
 
+class OpeningBook;
+class SearchControl;
+struct PieceSquareTables;
+struct SearchParams;
+
+// Search and evaluation scores in centipawns from the side to move's point of
+// view. Mate scores are encoded relative to the root: being mated at ply p is
+// matedIn(p), so shorter mates always score better than longer ones.
+typedef int32_t Score;
+
+const int MAX_PLY = 128;
+// Deepest iteration searched. Extensions keep every node below MAX_PLY, and
+// the depth still fits the int8_t of a table entry.
+const int MAX_DEPTH = MAX_PLY - 8;
+const Score SCORE_DRAW = 0;
+const Score SCORE_MATE = 20000;
+const Score SCORE_MATE_IN_MAX_PLY = SCORE_MATE - MAX_PLY;
+const Score SCORE_INFINITE = 30000;
+
+// Evaluations blend middlegame and endgame terms by an integer game phase
+// running from 0 (all material on the board) to PHASE_MAX (bare kings).
+const int PHASE_MAX = 256;
+
+inline Score mateIn(int ply) { return SCORE_MATE - ply; }
+inline Score matedIn(int ply) { return -SCORE_MATE + ply; }
+inline bool isMateScore(Score score) { return score >= SCORE_MATE_IN_MAX_PLY || score <= -SCORE_MATE_IN_MAX_PLY; }
+
+// The TT stores mate scores relative to the stored node rather than the root,
+// so an entry stays correct when the position is reached at another ply.
+inline Score scoreToTT(Score score, int ply) {
+    if (score >= SCORE_MATE_IN_MAX_PLY) return score + ply;
+    if (score <= -SCORE_MATE_IN_MAX_PLY) return score - ply;
+    return score;
+}
+
+inline Score scoreFromTT(Score score, int ply) {
+    if (score >= SCORE_MATE_IN_MAX_PLY) return score - ply;
+    if (score <= -SCORE_MATE_IN_MAX_PLY) return score + ply;
+    return score;
+}
 
 class Move {
 public:
@@ -52,23 +93,94 @@ public:
 
 extern const Move NO_MOVE;
 
-enum TTFlag {
+enum TTFlag : uint8_t {
     HASH_FLAG_EXACT,  // Exact score
     HASH_FLAG_LOWER,  // Lower bound score
-    HASH_FLAG_UPPER,  // Upper bound score
-    HASH_BOOK
+    HASH_FLAG_UPPER   // Upper bound score
 };
 
+// The table is shared by all search threads without locking. In the table the
+// key is stored XORed with the rest of the entry, so a slot torn by two
+// threads writing at once decodes to a wrong key and reads as a miss. Always
+// go through probeTranspositionTable/record_tt_entry rather than the raw slots.
 struct TT_Entry { 
     uint64_t key;     // Zobrist key of the position
     Move move;        // Best move from this position
-    int score;        // Evaluation score
-    int depth;        // Depth at which the position was evaluated
-    TTFlag flag;      // Type of node
+    int16_t score;    // Score, with mates relative to this node (see scoreToTT)
+    int8_t depth;     // Depth at which the position was evaluated
+    TTFlag flag : 2;  // Type of node
+    uint8_t generation : 6;  // Board::ttGeneration of the search that stored it
+
+    TT_Entry() : key(0), move(NO_MOVE), score(0), depth(0), flag(HASH_FLAG_EXACT), generation(0) {}
+};
+static_assert(sizeof(TT_Entry) == 3 * sizeof(uint64_t), "TT_Entry must be a key plus two payload words");
+const int TT_GENERATIONS = 64;  // Generations wrap around within the 6 bits
+
+// Cheap running counters for transposition table usage. They are kept per
+// Board so that the search never has to synchronise on them.
+struct TTStats {
+    uint64_t probes = 0;        // Table lookups
+    uint64_t hits = 0;          // Lookups that found the same position
+    uint64_t collisions = 0;    // Lookups that found a different position in the slot
+    uint64_t exactCutoffs = 0;  // Nodes answered by an exact stored score
+    uint64_t boundCutoffs = 0;  // Nodes answered by a stored lower or upper bound
+    uint64_t stores = 0;        // Entries written
+    uint64_t overwrites = 0;    // Writes that evicted a different position
+    int hashfull = 0;           // Sampled occupancy in per mille, see Board::hashfull()
+};
 
-    TT_Entry() : key(0), score(0), depth(0), flag(HASH_FLAG_EXACT), move(NO_MOVE) {}
+// Search counters, only incremented in builds with SEARCH_STATS defined (see
+// searchstats.h). Per Board like TTStats, so every thread counts its own.
+struct SearchStats {
+    uint64_t nodes = 0;             // Main search nodes entered
+    uint64_t qnodes = 0;            // Quiescence nodes entered
+    uint64_t betaCutoffs = 0;       // Moves that failed high
+    uint64_t firstMoveCutoffs = 0;  // ... with the first move searched
+    uint64_t nullMoveTries = 0;
+    uint64_t nullMoveCutoffs = 0;   // After verification where that applies
+    uint64_t reducedSearches = 0;   // Late move reductions
+    uint64_t reSearches = 0;        // Reduced searches that beat alpha and were repeated at full depth
+
+    SearchStats since(const SearchStats& earlier) const {
+        SearchStats delta;
+        delta.nodes = nodes - earlier.nodes;
+        delta.qnodes = qnodes - earlier.qnodes;
+        delta.betaCutoffs = betaCutoffs - earlier.betaCutoffs;
+        delta.firstMoveCutoffs = firstMoveCutoffs - earlier.firstMoveCutoffs;
+        delta.nullMoveTries = nullMoveTries - earlier.nullMoveTries;
+        delta.nullMoveCutoffs = nullMoveCutoffs - earlier.nullMoveCutoffs;
+        delta.reducedSearches = reducedSearches - earlier.reducedSearches;
+        delta.reSearches = reSearches - earlier.reSearches;
+        return delta;
+    }
+};
+
+// Quiet move ordering statistics learned from beta cutoffs. Piece indices
+// follow Board::getPieceIndex. The tables live on the heap because the
+// continuation tables are too large for a Board on the stack, and they are
+// copied with the Board so every search thread learns its own.
+struct MoveHistory {
+    static constexpr int MAX_HISTORY = 16384;  // Scores stay within +-MAX_HISTORY
+
+    std::vector<int16_t> butterfly;        // [side][from][to]
+    std::vector<Move> counterMoves;        // [piece][to] of the move being answered
+    std::vector<int16_t> continuation[2];  // [earlier piece][earlier to][piece][to], one and two plies back
+
+    MoveHistory();
+    void clear();
+    void age();  // Halves every score so a new search still starts from the old ordering
+
+    static int butterflyIndex(bool white, int from, int to) { return ((white ? 1 : 0) * 64 + from) * 64 + to; }
+    static int continuationIndex(int earlierPiece, int earlierTo, int piece, int to) { return ((earlierPiece * 64 + earlierTo) * 12 + piece) * 64 + to; }
 };
 
+// Piece and destination of the move made at one ply of the current search,
+// and the static evaluation of the node at that ply
+struct SearchPly {
+    int piece = -1;  // -1 for a null move or nothing made yet
+    int to = 0;
+    Score staticEval = -SCORE_INFINITE;  // -SCORE_INFINITE when in check
+};
 
 class Board {
 public:
@@ -109,7 +221,9 @@ public:
     Move lastMove;
 
     std::unordered_map<uint64_t, int> positionHistory;
-    Move killerMoves[2][64]; // Two killer moves per depth, up to depth of 64
+    Move killerMoves[2][MAX_PLY]; // Two killer moves per ply
+    MoveHistory history;
+    SearchPly searchStack[MAX_PLY];
 
     Board();
     void createBoard();
@@ -122,10 +236,21 @@ public:
     std::vector<Move> generateKingMoves(Bitboard king, Bitboard ownPieces, Bitboard opponentPieces);
     std::vector<Move> generateQueenMoves(Bitboard queens, Bitboard ownPieces, Bitboard opponentPieces);
     std::vector<Move> generateAllMoves();
+    // Pseudo-legal captures and queen promotions for the quiescence search. Unlike
+    // generateAllMoves the moves are not checked for legality, the caller has to
+    // reject any that leave its king in check.
+    std::vector<Move> generateCaptures() const;
     bool amIInCheck(bool player);
     void makeMove(Move& move);
     void undoMove(const Move& move);
     bool isSquareAttacked(int square, bool byWhite);
+    // Pieces of both colours attacking square, with only the pieces in occupied
+    // present and blocking
+    Bitboard attackersTo(int square, Bitboard occupied) const;
+    // Static exchange evaluation: material the side to move wins (negative if
+    // it loses) when both sides keep recapturing on move.to with their least
+    // valuable piece and either may stop. Works for quiet moves too.
+    int see(const Move& move) const;
     char getPieceAt(int index) const;
 
     void updatePositionHistory(bool plus);
@@ -135,26 +260,60 @@ public:
     int getEnPassantFile() const;
     uint64_t generateZobristHash() const;
 
-    std::vector<TT_Entry> transposition_table;
+    // Copies of a board share its table, so search threads working on their own
+    // copy of the position all read and write the same entries
+    std::shared_ptr<std::vector<TT_Entry>> transposition_table;
+    // Counts searches, so entries left by earlier ones give way to new ones.
+    // Copied with the board, so every thread of a search stores the same.
+    uint8_t ttGeneration = 0;
+    void newTTGeneration() { ttGeneration = (ttGeneration + 1) % TT_GENERATIONS; }
     void resize_tt(uint64_t mb);
     void clear_tt();
-    void record_tt_entry(uint64_t hash_key, int score, TTFlag flag, Move move, int depth);
+    void record_tt_entry(uint64_t hash_key, Score score, TTFlag flag, Move move, int depth);
     void configureTranspositionTableSize(uint64_t sizeInMB);
-    short probe_tt_entry(uint64_t hash_key, int alpha, int beta, int depth, TT_Entry& return_entry);
-    TT_Entry* probeTranspositionTable(uint64_t hash);
+    short probe_tt_entry(uint64_t hash_key, Score alpha, Score beta, int depth, TT_Entry& return_entry);
+    TT_Entry probeTranspositionTable(uint64_t hash);
     size_t countTranspositionTableEntries() const;
+    TTStats ttStats;
+    SearchStats searchStats;
+    // Nodes searched on this board, every node and quiescence node counts once.
+    // Per Board like TTStats, so every thread counts its own.
+    uint64_t nodes = 0;
+    int hashfull() const;
+    void recordTTCutoff(TTFlag flag);
     void makeNullMove();
     void undoNullMove();
 
+    // Remembers the move about to be searched at ply, call before makeMove
+    void recordSearchMove(int ply, const Move& move);
+    int quietMoveScore(const Move& move, int ply) const;
+    Move counterMove(int ply) const;
+    // Rewards the quiet move that caused a cutoff and penalises the quiet
+    // moves searched before it
+    void updateQuietHistory(const Move& best, const Move* quietsSearched, int quietCount, int depth, int ply);
+
+    // Stops searches on this board, the global searchControl unless a search
+    // running alongside another (pondering) gives its copy of the board its own
+    SearchControl* searchControl = nullptr;
+    // Evaluation tables and search parameters of the Engine the board belongs
+    // to, nullptr for the global defaults
+    const PieceSquareTables* pieceSquareTables = nullptr;
+    const SearchParams* searchParams = nullptr;
+
+    const OpeningBook* openingBook = nullptr;
     void loadOpeningBook();
+    bool probeOpeningBook(Move& move);
 };
 
 // Helper functions
+unsigned int ctzll(unsigned long long x);
 void setBit(Bitboard& bitboard, int square);
 void parseFEN(const std::string& fen, Board& board);
 std::string numToBoardPosition(int num);
-std::vector<Move> orderMoves(Board& board, const std::vector<Move>& moves, TT_Entry* ttEntry, int depth);
-bool isTacticalPosition(std::vector<Move> moves, Board board);
+int getPieceValue(char piece);
+bool isTacticalPosition(const std::vector<Move>& moves, const Board& board);
 bool isNullViable(Board& board);
 Move convertToMoveObject(const std::string& moveStr);
+// Coordinate notation, e.g. "e2e4" or "e7e8q"
+std::string moveToString(const Move& move);
 int boardPositionToIndex(const std::string& pos);
@@ -3,11 +3,11 @@
 #include <fstream>
 #include <sstream>
 #include <chrono>
+#include <iterator>
 #include <string>
 
-std::chrono::time_point<std::chrono::high_resolution_clock> endTime;
-
-int64_t pawn_pcsq[64] = {
+// Defaults of the piece-square tables, training/train_pcsq.py reads them from here
+static const int64_t pawn_pcsq[64] = {
       0,   0,   0,   0,   0,   0,   0,   0,
      15,  20,  30,  40,  40,  30,  20,  15,
      10,  10,  20,  30,  30,  20,  10,  10,
@@ -18,7 +18,7 @@ int64_t pawn_pcsq[64] = {
       0,   0,   0,   0,   0,   0,   0,   0
 };
 
-int64_t knight_pcsq[64] = {
+static const int64_t knight_pcsq[64] = {
     -50, -40, -30, -30, -30, -30, -40, -50,
     -40, -20,   0,   0,   0,   0, -20, -40,
     -30,   0,  10,  15,  15,  10,   0, -30,
@@ -29,7 +29,7 @@ int64_t knight_pcsq[64] = {
     -50, -40, -30, -30, -30, -30, -40, -50
 };
 
-int64_t bishop_pcsq[64] = {
+static const int64_t bishop_pcsq[64] = {
     -10, -10, -10, -10, -10, -10, -10, -10,
     -10,   0,   0,   0,   0,   0,   0, -10,
     -10,   0,   5,   5,   5,   5,   0, -10,
@@ -40,7 +40,7 @@ int64_t bishop_pcsq[64] = {
     -10, -10, -20, -10, -10, -20, -10, -10
 };
 
-int64_t king_pcsq[64] = {
+static const int64_t king_pcsq[64] = {
     -40, -40, -40, -40, -40, -40, -40, -40,
     -40, -40, -40, -40, -40, -40, -40, -40,
     -40, -40, -40, -40, -40, -40, -40, -40,
@@ -51,7 +51,7 @@ int64_t king_pcsq[64] = {
       0,  20,  40, -20,   0, -20,  40,  20
 };
 
-int64_t king_pcsq_black[64] = {
+static const int64_t king_pcsq_black[64] = {
     -40, -40, -40, -40, -40, -40, -40, -40,
     -40, -40, -40, -40, -40, -40, -40, -40,
     -40, -40, -40, -40, -40, -40, -40, -40,
@@ -62,7 +62,7 @@ int64_t king_pcsq_black[64] = {
      20,  40, -20,   0, -20,  40,  20,   0  
 };
 
-int64_t king_endgame_pcsq[64] = {
+static const int64_t king_endgame_pcsq[64] = {
     -40, -30, -20, -10, -10, -20, -30, -40,
     -30, -10,   0,  10,  10,   0, -10, -30,
     -20,   0,  30,  50,  50,  30,   0, -20,
@@ -72,7 +72,24 @@ int64_t king_endgame_pcsq[64] = {
     -30, -10,   0,  10,  10,   0, -10, -30,
     -40, -30, -20, -10, -10, -20, -30, -40
 };
+static PieceSquareTables makeDefaultPieceSquareTables() {
+    PieceSquareTables tables;
+    std::copy(std::begin(pawn_pcsq), std::end(pawn_pcsq), tables.pawn);
+    std::copy(std::begin(knight_pcsq), std::end(knight_pcsq), tables.knight);
+    std::copy(std::begin(bishop_pcsq), std::end(bishop_pcsq), tables.bishop);
+    std::copy(std::begin(king_pcsq), std::end(king_pcsq), tables.king);
+    std::copy(std::begin(king_pcsq_black), std::end(king_pcsq_black), tables.kingBlack);
+    std::copy(std::begin(king_endgame_pcsq), std::end(king_endgame_pcsq), tables.kingEndgame);
+    return tables;
+}
+
+PieceSquareTables defaultPieceSquareTables = makeDefaultPieceSquareTables();
+
 bool loadPieceSquareTables(const std::string& file) {
+    return loadPieceSquareTables(file, defaultPieceSquareTables);
+}
+
+bool loadPieceSquareTables(const std::string& file, PieceSquareTables& tables) {
     std::ifstream in(file);
     if(!in) return false;
     std::string data((std::istreambuf_iterator<char>(in)), {});
@@ -90,29 +107,18 @@ bool loadPieceSquareTables(const std::string& file) {
             arr[i] = std::stoll(token);
         }
     };
-    parse("pawn_pcsq", pawn_pcsq);
-    parse("knight_pcsq", knight_pcsq);
-    parse("bishop_pcsq", bishop_pcsq);
-    parse("king_pcsq", king_pcsq);
-    parse("king_pcsq_black", king_pcsq_black);
-    parse("king_endgame_pcsq", king_endgame_pcsq);
+    parse("pawn_pcsq", tables.pawn);
+    parse("knight_pcsq", tables.knight);
+    parse("bishop_pcsq", tables.bishop);
+    parse("king_pcsq", tables.king);
+    parse("king_pcsq_black", tables.kingBlack);
+    parse("king_endgame_pcsq", tables.kingEndgame);
     return ok;
 }
 
-unsigned int ctzll2(unsigned long long x) {
-    if (x == 0) return 64;
-#ifdef _MSC_VER
-    unsigned long index;
-    _BitScanForward64(&index, x);
-    return index;
-#else
-    return __builtin_ctzll(x);
-#endif
-}
-
 int kingDistance(uint64_t king1, uint64_t king2) {
-    int index1 = ctzll2(king1);
-    int index2 = ctzll2(king2);
+    int index1 = ctzll(king1);
+    int index2 = ctzll(king2);
 
     int x1 = index1 % 8;
     int y1 = index1 / 8;
@@ -122,18 +128,18 @@ int kingDistance(uint64_t king1, uint64_t king2) {
     return std::max(std::abs(x1 - x2), std::abs(y1 - y2));
 }
 
-double_t evaluate(Board& board) {
+Score evaluate(Board& board) {
     // Check for draw condition based on insufficient material
     if ((std::_Popcount(board.whitePieces) == 1) && (std::_Popcount(board.blackPieces) == 1)) {
-        return 0; // Return 0 to indicate a draw
+        return SCORE_DRAW;
     }
-    double_t result = 0;
+    Score result = 0;
 
-    const double_t pawnValue = 100;
-    const double_t knightValue = 325;
-    const double_t bishopValue = 325;
-    const double_t rookValue = 500;
-    const double_t queenValue = 975;
+    const Score pawnValue = 100;
+    const Score knightValue = 325;
+    const Score bishopValue = 325;
+    const Score rookValue = 500;
+    const Score queenValue = 975;
 
     int numWhitePawns = std::_Popcount(board.whitePawns);
     int numWhiteBishops = std::_Popcount(board.whiteBishops);
@@ -173,33 +179,33 @@ double_t evaluate(Board& board) {
     int passedPawnBonus[8] = { 0, 10, 20, 30, 50, 70, 90, 0 }; // No bonus on rank 1 and rank 8
 
     // Rank masks
-    Bitboard rankMasks[12] = {
+    Bitboard rankMasks[8] = {
         0xFFULL, 0xFF00ULL, 0xFF0000ULL, 0xFF000000ULL, 0xFF00000000ULL, 0xFF0000000000ULL, 0xFF000000000000ULL, 0xFF00000000000000ULL
     };
 
 
-    // Calculate the game phase (0-1)
-    const double_t totalMaterial = 16 * pawnValue + 4 * knightValue + 4 * bishopValue + 4 * rookValue + 2 * queenValue;
-    double_t whiteMaterial = numWhitePawns * pawnValue +
+    // Calculate the game phase (0 at the start, PHASE_MAX with bare kings)
+    const Score totalMaterial = 16 * pawnValue + 4 * knightValue + 4 * bishopValue + 4 * rookValue + 2 * queenValue;
+    Score whiteMaterial = numWhitePawns * pawnValue +
         numWhiteKnights * knightValue +
         numWhiteBishops * bishopValue +
         numWhiteRooks * rookValue +
         numWhiteQueens * queenValue;
 
-    double_t blackMaterial = numBlackPawns * pawnValue +
+    Score blackMaterial = numBlackPawns * pawnValue +
         numBlackKnights * knightValue +
         numBlackBishops * bishopValue +
         numBlackRooks * rookValue +
         numBlackQueens * queenValue;
 
-    double_t currentMaterial = whiteMaterial + blackMaterial;
-    double_t gamePhase = ((totalMaterial - currentMaterial)) / totalMaterial;
+    Score currentMaterial = whiteMaterial + blackMaterial;
+    int gamePhase = (totalMaterial - currentMaterial) * PHASE_MAX / totalMaterial;
 
     // Helper function to get the positional value of a bitboard
-    auto getPositionalValueWhite = [](int64_t pieces, int64_t values[]) {
-        double_t positionalValue = 0;
+    auto getPositionalValueWhite = [](Bitboard pieces, const int64_t values[]) {
+        Score positionalValue = 0;
         while (pieces) {
-            int index = ctzll2(pieces);
+            int index = ctzll(pieces);
             positionalValue += values[63 - index];
             pieces &= pieces - 1;  // Clear the least significant bit set
         }
@@ -207,10 +213,10 @@ double_t evaluate(Board& board) {
         };
 
     // Helper function to get the positional value of a bitboard
-    auto getPositionalValueBlack = [](int64_t pieces, int64_t values[]) {
-        double_t positionalValue = 0;
+    auto getPositionalValueBlack = [](Bitboard pieces, const int64_t values[]) {
+        Score positionalValue = 0;
         while (pieces) {
-            int index = ctzll2(pieces);
+            int index = ctzll(pieces);
             positionalValue += values[index];
             pieces &= pieces - 1;  // Clear the least significant bit set
         }
@@ -218,7 +224,7 @@ double_t evaluate(Board& board) {
         };
 
     int numPawns = numWhitePawns + numBlackPawns;
-    double multiplierBishop = 5 * (16 - numPawns);
+    int multiplierBishop = 5 * (16 - numPawns);
 
     //Bishops worth more if there are less pawns
     result += numWhiteBishops * multiplierBishop;
@@ -234,12 +240,12 @@ double_t evaluate(Board& board) {
     }
 
     // no pawns is bad in lategame
-    if (gamePhase > 0.6) {
+    if (gamePhase > PHASE_MAX * 6 / 10) {
         if ((numWhitePawns < 1) && (numWhiteQueens == 0)) {
-            result -= 140 * gamePhase;
+            result -= 140 * gamePhase / PHASE_MAX;
         }
         if ((numBlackPawns < 1) && (numBlackQueens == 0)) {
-            result += 140 * gamePhase;
+            result += 140 * gamePhase / PHASE_MAX;
         }
     }
     // early game king safety
@@ -274,8 +280,8 @@ double_t evaluate(Board& board) {
         result -= calculateKingSafety(board.blackKing, board.blackPawns, false);
         
         // Get the file of the enemy king
-        int whiteKingFile = ctzll2(board.whiteKing) % 8;
-        int blackKingFile = ctzll2(board.blackKing) % 8;
+        int whiteKingFile = ctzll(board.whiteKing) % 8;
+        int blackKingFile = ctzll(board.blackKing) % 8;
 
         // Create a mask for the king's file and the adjacent files
         Bitboard whiteKingFileMask = 0;
@@ -323,20 +329,21 @@ double_t evaluate(Board& board) {
     }
 
     // Calculate white pieces' value and positional value
+    const PieceSquareTables& tables = pieceSquareTables(board);
     result += whiteMaterial;
-    result += getPositionalValueWhite(board.whitePawns, pawn_pcsq) * (1 - gamePhase);
-    result += getPositionalValueWhite(board.whiteKnights, knight_pcsq);
-    result += getPositionalValueWhite(board.whiteBishops, bishop_pcsq);
-    result += (gamePhase * getPositionalValueWhite(board.whiteKing, king_endgame_pcsq)) +
-        ((1 - gamePhase) * getPositionalValueWhite(board.whiteKing, king_pcsq));
+    result += getPositionalValueWhite(board.whitePawns, tables.pawn) * (PHASE_MAX - gamePhase) / PHASE_MAX;
+    result += getPositionalValueWhite(board.whiteKnights, tables.knight);
+    result += getPositionalValueWhite(board.whiteBishops, tables.bishop);
+    result += ((gamePhase * getPositionalValueWhite(board.whiteKing, tables.kingEndgame)) +
+        ((PHASE_MAX - gamePhase) * getPositionalValueWhite(board.whiteKing, tables.king))) / PHASE_MAX;
 
     // Calculate black pieces' value and positional value
     result -= blackMaterial;
-    result -= getPositionalValueBlack(board.blackPawns, pawn_pcsq) * (1 - gamePhase);
-    result -= getPositionalValueBlack(board.blackKnights, knight_pcsq);
-    result -= getPositionalValueBlack(board.blackBishops, bishop_pcsq);
-    result -= (gamePhase * getPositionalValueBlack(board.blackKing, king_endgame_pcsq)) +
-        ((1 - gamePhase) * getPositionalValueBlack(board.blackKing, king_pcsq_black));
+    result -= getPositionalValueBlack(board.blackPawns, tables.pawn) * (PHASE_MAX - gamePhase) / PHASE_MAX;
+    result -= getPositionalValueBlack(board.blackKnights, tables.knight);
+    result -= getPositionalValueBlack(board.blackBishops, tables.bishop);
+    result -= ((gamePhase * getPositionalValueBlack(board.blackKing, tables.kingEndgame)) +
+        ((PHASE_MAX - gamePhase) * getPositionalValueBlack(board.blackKing, tables.kingBlack))) / PHASE_MAX;
 
     // Penalize double pawns
     for (int file = 0; file < 8; ++file) {
@@ -346,8 +353,8 @@ double_t evaluate(Board& board) {
         if (blackPawnCount > 1) result += 20 * (blackPawnCount - 1);
     }
 
-    if (gamePhase > 0.3) {
-        double_t lateGamePawnPos = 0;
+    if (gamePhase > PHASE_MAX * 3 / 10) {
+        Score lateGamePawnPos = 0;
         for (int rank = 1; rank <= 6; ++rank) { // Skipping rank 0 and 7 (no pawns can be there)
             Bitboard whiteRankPawns = board.whitePawns & rankMasks[rank];
             Bitboard blackRankPawns = board.blackPawns & rankMasks[7 - rank];
@@ -362,7 +369,7 @@ double_t evaluate(Board& board) {
                 if (whitePawn) {
                     Bitboard blockingPawns = board.blackPawns & (
                         (fileMasks[file] | (file > 0 ? fileMasks[file - 1] : 0) | (file < 7 ? fileMasks[file + 1] : 0)) &
-                        (rankMasks[rank + 1] | rankMasks[rank + 2] | rankMasks[rank + 3] | rankMasks[rank + 4] | rankMasks[rank + 5] | rankMasks[rank + 6])
+                        (~0ULL << (8 * (rank + 1))) // Every rank in front of the pawn
                         );
                     if (!blockingPawns) {
                         lateGamePawnPos += passedPawnBonus[rank];
@@ -373,7 +380,7 @@ double_t evaluate(Board& board) {
                 if (blackPawn) {
                     Bitboard blockingPawns = board.whitePawns & (
                         (fileMasks[file] | (file > 0 ? fileMasks[file - 1] : 0) | (file < 7 ? fileMasks[file + 1] : 0)) &
-                        (rankMasks[6 - rank] | rankMasks[5 - rank] | rankMasks[4 - rank] | rankMasks[3 - rank] | rankMasks[2 - rank] | rankMasks[1 - rank])
+                        ((1ULL << (8 * (7 - rank))) - 1) // Every rank in front of the pawn
                         );
                     if (!blockingPawns) {
                         lateGamePawnPos -= passedPawnBonus[rank];
@@ -382,7 +389,7 @@ double_t evaluate(Board& board) {
             }
         }
 
-        result += lateGamePawnPos * (gamePhase) * 1.5;
+        result += lateGamePawnPos * gamePhase * 3 / (2 * PHASE_MAX);
     }
 
 
@@ -409,10 +416,10 @@ double_t evaluate(Board& board) {
     result -= 6 * board.generateQueenMoves(board.blackQueens, board.blackPieces, board.whitePieces).size();
 
     // reaching endgame
-    if ((gamePhase > 0.6)) {  
+    if ((gamePhase > PHASE_MAX * 6 / 10)) {  
         if (std::abs(result) > 400) {
             // Lead is expanded as game goes on, incentives trading
-            result = result * (1 + gamePhase / 2.5);
+            result = result * (5 * PHASE_MAX + 2 * gamePhase) / (5 * PHASE_MAX);
 
             int distBetweenKingsBonus[9] = { 0, 0, 140, 80, 40, 20, 0, -10, -20 };
             int distBetweenKings = kingDistance(board.blackKing, board.whiteKing); // smaller is better
@@ -427,92 +434,15 @@ double_t evaluate(Board& board) {
     return board.whiteToMove ? result : -result;
 }
 
-std::vector<Move> generateCaptures(Board& board, std::vector<Move> allMoves);
-
-std::vector<Move> generateCaptures(Board& board, std::vector<Move> allMoves) {
-    std::vector<Move> captures;
-
-    for (Move& move : allMoves) {
-        if (move.isCapture) {
-            captures.push_back(move);
-        }
-    }
-
-    // Optional: sort captures based on some heuristic, e.g., MVV-LVA (Most Valuable Victim - Least Valuable Attacker)
-    std::sort(captures.begin(), captures.end(), [](const Move& a, const Move& b) {
-        return a.capturedPiece > b.capturedPiece;
-        });
-
-    return captures;
+// Counters since the last reset together with a freshly sampled hashfull
+TTStats getTTStats(const Board& board) {
+    TTStats stats = board.ttStats;
+    stats.hashfull = board.hashfull();
+    return stats;
 }
 
-double_t quiescenceSearch(Board& board, double_t alpha, double_t beta);
-double_t quiescenceSearch(Board& board, double_t alpha, double_t beta) {
-    uint64_t hash = board.generateZobristHash();
-    TT_Entry* ttEntry = board.probeTranspositionTable(hash);
-
-    if (ttEntry->key == hash && ttEntry->depth == 0) {
-        if (ttEntry->flag == TTFlag::HASH_FLAG_EXACT) return ttEntry->score;
-        if (ttEntry->flag == TTFlag::HASH_FLAG_LOWER && ttEntry->score >= beta) return ttEntry->score;
-        if (ttEntry->flag == TTFlag::HASH_FLAG_UPPER && ttEntry->score <= alpha) return ttEntry->score;
-    }
-
-    double_t stand_pat = evaluate(board);
-    if (stand_pat >= beta) {
-        return beta;
-    }
-    if (alpha < stand_pat) {
-        alpha = stand_pat;
-    }
-    double_t checkmate = -20000;
-    double_t draw = 0;
-    std::vector<Move> allMoves = board.generateAllMoves();
-    if (allMoves.empty()) {
-        return { board.amIInCheck(board.whiteToMove) ? checkmate : draw };
-    }
-    std::vector<Move> moves = generateCaptures(board, allMoves);
-
-    moves = orderMoves(board, moves, ttEntry, 0);
-
-    double_t subBestScore;
-    Bitboard store = board.enPassantTarget;
-    bool whiteKingMovedStore = board.whiteKingMoved;
-    bool whiteLRookMovedStore = board.whiteLRookMoved;
-    bool whiteRRookMovedStore = board.whiteRRookMoved;
-    bool blackKingMovedStore = board.blackKingMoved;
-    bool blackLRookMovedStore = board.blackLRookMoved;
-    bool blackRRookMovedStore = board.blackRRookMoved;
-
-    for (Move& move : moves) {
-        board.makeMove(move);
-
-        if (!board.isThreefoldRepetition(false)) {
-            subBestScore = -quiescenceSearch(board, -beta, -alpha);
-        }
-        else {
-            subBestScore = 0;
-        }
-
-        board.enPassantTarget = store;
-        board.whiteKingMoved = whiteKingMovedStore;
-        board.whiteLRookMoved = whiteLRookMovedStore;
-        board.whiteRRookMoved = whiteRRookMovedStore;
-        board.blackKingMoved = blackKingMovedStore;
-        board.blackLRookMoved = blackLRookMovedStore;
-        board.blackRRookMoved = blackRRookMovedStore;
-        board.undoMove(move);
-
-        if (subBestScore >= beta) {
-            return beta;
-        }
-        if (subBestScore > alpha) {
-            alpha = subBestScore;
-        }
-        if (alpha >= beta) {
-            break;
-        }
-    }
-    return alpha;
+void resetTTStats(Board& board) {
+    board.ttStats = TTStats();
 }
 
 std::string numToBoardPosition2(int num) {
@@ -577,173 +507,11 @@ int perftHelper(Board& board, int depth, int startDepth) {
     return { totalMoves };
 }
 
-std::tuple<Move, double_t> engine(Board& board, int depth, std::vector<std::tuple<Move, double_t>>& iterativeDeepeningMoves, double_t alpha, double_t beta) {
-    double bestScore;
-    Move bestMove;
-    std::tie(bestMove, bestScore) = engineHelper(board, depth, alpha, beta, depth, iterativeDeepeningMoves, 0, false);
-    return { bestMove, bestScore };
-}
-
-std::tuple<Move, double_t> engineHelper(Board& board, int depth, double_t alpha, double_t beta, int startDepth, std::vector<std::tuple<Move, double_t>>& iterativeDeepeningMoves, int totalExtensions, bool lastIterationNull) {
-    if (std::chrono::high_resolution_clock::now() > endTime) {
-        return { Move(), -1.2345 };
-    }
-    
-    const int MAX_EXTENSIONS = 3;
-    const int MAX_EXTENSION_DEPTH = 3;
-    const double_t INITIAL_WINDOW = 50.0; // Initial aspiration window value
-    int extension = 0;
-    
-    uint64_t hash = board.generateZobristHash();
-    TT_Entry* ttEntry = board.probeTranspositionTable(hash);
-
-    if (ttEntry->key == hash) {
-        if (depth == startDepth && ttEntry->flag == TTFlag::HASH_BOOK) {
-            return { ttEntry->move, 0 };
-        }
-        else if (ttEntry->depth >= depth) {
-            if (ttEntry->flag == TTFlag::HASH_FLAG_EXACT) return { ttEntry->move, ttEntry->score };
-            if (ttEntry->flag == TTFlag::HASH_FLAG_LOWER && ttEntry->score >= beta) return { ttEntry->move, ttEntry->score };
-            if (ttEntry->flag == TTFlag::HASH_FLAG_UPPER && ttEntry->score <= alpha) return { ttEntry->move, ttEntry->score };
-        }
-    }
-
-    std::vector<Move> moves;
-    if (depth == startDepth && !iterativeDeepeningMoves.empty()) {
-        // Extract moves from the tuples for use in this depth
-        std::transform(iterativeDeepeningMoves.begin(), iterativeDeepeningMoves.end(), std::back_inserter(moves),
-            [](const std::tuple<Move, double_t>& pair) { return std::get<0>(pair); });
-    }
-    else {
-        moves = board.generateAllMoves();
-        if (moves.empty()) {
-            if (board.amIInCheck(board.whiteToMove)) {
-                return { Move(), -20000 }; // checkmate
-            }
-            else {
-                return { Move(), 0 }; // stalemate
-            }
-        }
-        else if (depth == 0) {
-            double_t val = quiescenceSearch(board, alpha, beta);
-            return { Move(), val };
-        }
-        moves = orderMoves(board, moves, ttEntry, depth);
-    }
-    
-    // Null Move Pruning
-    if (!board.amIInCheck(board.whiteToMove) && depth > 2 && isNullViable(board) && !lastIterationNull && depth != startDepth) {
-        board.makeNullMove();
-        int R = 2;
-        std::tuple<Move, double_t> result = engineHelper(board, depth - 1 - R, -beta, -beta + 1, startDepth, iterativeDeepeningMoves, totalExtensions, true);
-        double_t nullMoveEvaluation = -std::get<1>(result);
-        board.undoNullMove();
-
-        // null move cutoff
-        if (nullMoveEvaluation >= beta) {
-            return { Move(), beta }; // Cutoff
-        }
-
-        // mate threat extension
-        if (totalExtensions < MAX_EXTENSIONS) {
-            if (nullMoveEvaluation + 100 <= alpha) {
-                extension = 1;
-            }
-        }
-    }
-    
-
-    Move bestMove;
-    double_t bestScore = -100000;
-    Bitboard store = board.enPassantTarget;
-    bool whiteKingMovedStore = board.whiteKingMoved;
-    bool whiteLRookMovedStore = board.whiteLRookMoved;
-    bool whiteRRookMovedStore = board.whiteRRookMoved;
-    bool blackKingMovedStore = board.blackKingMoved;
-    bool blackLRookMovedStore = board.blackLRookMoved;
-    bool blackRRookMovedStore = board.blackRRookMoved;
-    double_t subBestScore;
-    Move subBestMove;
-    std::vector<std::tuple<Move, double_t>> moveScores;
-
-    for (int i = 0; i < size(moves); i++) {
-        Move& move = moves[i];
-        board.makeMove(move);
-
-        if (!board.isThreefoldRepetition()) {
-            bool needsFullSearch = true;
-            // Lets do a reduced depth search for the less promising moves
-            if (i >= 3 && extension == 0 && depth >= 4 && !move.isCapture) {
-                int depthReduction;
-
-                if (i >= (size(moves) * 4 / 5)) {
-                    depthReduction = 2;
-                }
-                else {
-                    depthReduction = 1;
-                }
-                std::tie(subBestMove, subBestScore) = engineHelper(board, depth - 1 - depthReduction, -beta, -alpha, startDepth, iterativeDeepeningMoves, totalExtensions, false);
-                subBestScore = -subBestScore;
-
-                needsFullSearch = subBestScore > alpha;
-            }
-
-            if (needsFullSearch) {
-                std::tie(subBestMove, subBestScore) = engineHelper(board, depth - 1 + extension, -beta, -alpha, startDepth, iterativeDeepeningMoves, totalExtensions + extension, false);
-                subBestScore = -subBestScore;
-            }
-        }
-        else {
-            subBestScore = 0;
-        }
-        board.enPassantTarget = store;
-        board.whiteKingMoved = whiteKingMovedStore;
-        board.whiteLRookMoved = whiteLRookMovedStore;
-        board.whiteRRookMoved = whiteRRookMovedStore;
-        board.blackKingMoved = blackKingMovedStore;
-        board.blackLRookMoved = blackLRookMovedStore;
-        board.blackRRookMoved = blackRRookMovedStore;
-        board.undoMove(move);
-
-        if (subBestScore == 1.2345) {
-            return { Move(), -1.2345 };
-        }
-
-        if (depth == startDepth) {
-            moveScores.emplace_back(move, subBestScore);
-        }
-
-        if (subBestScore >= beta) {
-            board.record_tt_entry(hash, beta, HASH_FLAG_LOWER, move, depth);
-            return { move, beta };
-        }
-
-        if (subBestScore > bestScore) {
-            bestScore = subBestScore;
-            bestMove = move;
-        }
-
-        if (bestScore > alpha) {
-            alpha = bestScore;
-        }
-
-        if (alpha >= beta) {
-            break;
-        }
-    }
-
-
-
-    if (depth == startDepth) {
-        // Sort moves based on scores for next iterative deepening step
-        std::sort(moveScores.begin(), moveScores.end(), [](const std::tuple<Move, double_t>& a, const std::tuple<Move, double_t>& b) {
-            return std::get<1>(a) > std::get<1>(b); // Sort descending by score
-            });
-        iterativeDeepeningMoves = moveScores; // Update iterativeDeepeningMoves for next iteration
-    }
-
-    TTFlag flag = (bestScore <= alpha) ? HASH_FLAG_UPPER : HASH_FLAG_EXACT;
-    board.record_tt_entry(hash, bestScore, flag, bestMove, depth);
+// Evaluation policy of this engine for the shared search
+struct EngineEvaluator {
+    static Score evaluate(Board& board) { return ::evaluate(board); }
+};
 
-    return { bestMove, bestScore };
-}
\ No newline at end of file
+std::tuple<Move, Score> engine(Board& board, int depth, std::vector<std::tuple<Move, Score>>& iterativeDeepeningMoves, Score alpha, Score beta) {
+    return Search<EngineEvaluator>::root(board, depth, iterativeDeepeningMoves, alpha, beta);
+}
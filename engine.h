@@ -1,6 +1,7 @@
 #pragma once
 
 #include "chess.h"
+#include "search.h"
 #include <tuple>
 #include <iostream>
 #include <chrono>
@@ -8,10 +9,31 @@
 int perft(Board& board, int depth, int startDepth);
 int perftHelper(Board& board, int depth, int startDepth);
 
-std::tuple<Move, double_t> engine(Board& board, int depth, std::vector<std::tuple<Move, double_t>>& iterativeDeepeningMoves, double_t alpha, double_t beta);
-std::tuple<Move, double_t> engineHelper(Board& board, int depth, double_t alpha, double_t beta, int startDepth, std::vector<std::tuple<Move, double_t>>& iterativeDeepeningMoves, int totalExtensions, bool lastIterationNull);
-std::vector<Move> generateCaptures(Board& board, std::vector<Move> allMoves);
-double_t evaluate(Board& board);
-bool loadPieceSquareTables(const std::string& path);
+std::tuple<Move, Score> engine(Board& board, int depth, std::vector<std::tuple<Move, Score>>& iterativeDeepeningMoves, Score alpha, Score beta);
+Score evaluate(Board& board);
+int kingDistance(uint64_t king1, uint64_t king2);
 
-extern std::chrono::time_point<std::chrono::high_resolution_clock> endTime;
\ No newline at end of file
+// Piece-square tables read by both evaluations
+struct PieceSquareTables {
+    int64_t pawn[64];
+    int64_t knight[64];
+    int64_t bishop[64];
+    int64_t king[64];
+    int64_t kingBlack[64];
+    int64_t kingEndgame[64];
+};
+
+// Used by boards that do not belong to an Engine with tables of its own
+extern PieceSquareTables defaultPieceSquareTables;
+
+inline const PieceSquareTables& pieceSquareTables(const Board& board) {
+    return board.pieceSquareTables ? *board.pieceSquareTables : defaultPieceSquareTables;
+}
+
+// Reads the tables written by training/train_pcsq.py into the defaults or
+// into tables. Returns false if the file is missing or incomplete.
+bool loadPieceSquareTables(const std::string& path);
+bool loadPieceSquareTables(const std::string& path, PieceSquareTables& tables);
+
+TTStats getTTStats(const Board& board);
+void resetTTStats(Board& board);
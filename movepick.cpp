@@ -0,0 +1,75 @@
+#include "movepick.h"
+#include <algorithm>
+#include <utility>
+
+static const int SCORE_HASH_MOVE = 3000000;
+static const int SCORE_SHALLOW_HASH_MOVE = 2900000;
+static const int SCORE_CAPTURE = 2000000;
+static const int SCORE_KILLER = 1000000;
+static const int SCORE_COUNTER_MOVE = 900000;
+
+MovePicker::MovePicker(const Board& board, std::vector<Move>& moves, const TT_Entry* ttEntry, int depth, int ply)
+    : moves(moves), count(std::min((int)moves.size(), MAX_MOVES)) {
+    // Exact entries and fail-highs both carry a move worth trying first. Null window
+    // searches never produce exact entries, so relying on those alone would leave
+    // most nodes without a hash move.
+    bool usableHashMove = ttEntry && ttEntry->flag != HASH_FLAG_UPPER;
+    Move hashMove = (usableHashMove && ttEntry->depth >= depth) ? ttEntry->move : NO_MOVE;
+    Move shallowHashMove = (usableHashMove && ttEntry->depth >= (depth - 2)) ? ttEntry->move : NO_MOVE;
+    Move counterMove = board.counterMove(ply);
+
+    for (int i = 0; i < count; i++) {
+        const Move& move = moves[i];
+        if (move == hashMove) {
+            scores[i] = SCORE_HASH_MOVE;
+        }
+        else if (move == shallowHashMove) {
+            scores[i] = SCORE_SHALLOW_HASH_MOVE;
+        }
+        else if (move.isCapture || move.promotion) {
+            // Most valuable victim first, least valuable attacker breaks ties
+            int mvvLva = getPieceValue(move.capturedPiece) * 16 + getPieceValue(move.promotion) * 16 - getPieceValue(board.getPieceAt(move.from));
+            bool losing = move.isCapture && !move.promotion && board.see(move) < 0;
+            scores[i] = (losing ? SCORE_LOSING_CAPTURE - 1000 : SCORE_CAPTURE) + mvvLva;
+        }
+        else if (move == board.killerMoves[0][ply]) {
+            scores[i] = SCORE_KILLER;
+        }
+        else if (move == board.killerMoves[1][ply]) {
+            scores[i] = SCORE_KILLER - 1;
+        }
+        else if (move == counterMove) {
+            scores[i] = SCORE_COUNTER_MOVE;
+        }
+        else {
+            scores[i] = board.quietMoveScore(move, ply);
+        }
+    }
+}
+
+MovePicker::MovePicker(std::vector<Move>& moves)
+    : moves(moves), count(std::min((int)moves.size(), MAX_MOVES)) {
+    for (int i = 0; i < count; i++) {
+        scores[i] = 0;
+    }
+}
+
+bool MovePicker::next(Move& move) {
+    if (current >= count) {
+        return false;
+    }
+
+    // Ties go to the earliest move, so a list scored all equal keeps its order
+    int best = current;
+    for (int i = current + 1; i < count; i++) {
+        if (scores[i] > scores[best]) {
+            best = i;
+        }
+    }
+    if (best != current) {
+        std::swap(moves[best], moves[current]);
+        std::swap(scores[best], scores[current]);
+    }
+    move = moves[current++];
+    return true;
+}
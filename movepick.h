@@ -0,0 +1,45 @@
+#pragma once
+#ifndef MOVEPICK_H
+#define MOVEPICK_H
+
+#include "chess.h"
+#include <vector>
+
+// Hands out the moves of a node best first. Every move gets an integer score
+// up front, and next() swaps the best remaining one into place, a selection
+// sort that stops wherever the search does. Most nodes cut off on their first
+// or second move, so the rest of the list is never ordered.
+//
+// Score bands, highest first: hash move, captures that do not lose material
+// by SEE and promotions, killers, countermove, quiet moves by history, and
+// last the captures SEE says lose material. Captures within a band go most
+// valuable victim first.
+class MovePicker {
+public:
+    static constexpr int MAX_MOVES = 256;
+
+    // Scores moves for a search node. ttEntry may be null and must be the
+    // entry of this position, a slot holding another position's key is not.
+    MovePicker(const Board& board, std::vector<Move>& moves, const TT_Entry* ttEntry, int depth, int ply);
+    // Keeps the order moves are already in, used at the root where the
+    // previous iteration has sorted them
+    explicit MovePicker(std::vector<Move>& moves);
+
+    // Stores the best move not yet returned in move, false once all are used
+    bool next(Move& move);
+    int size() const { return count; }
+    // True if the move last returned by next() is a capture that loses
+    // material. These come after every other move.
+    bool losingCapture() const { return current > 0 && scores[current - 1] <= SCORE_LOSING_CAPTURE; }
+
+private:
+    // Losing captures score at or below this, under every quiet move
+    static constexpr int SCORE_LOSING_CAPTURE = -1000000;
+
+    std::vector<Move>& moves;
+    int scores[MAX_MOVES];
+    int count;
+    int current = 0;
+};
+
+#endif // MOVEPICK_H
@@ -0,0 +1,73 @@
+#include "ponder.h"
+#include <algorithm>
+
+Ponderer::~Ponderer() {
+    stop();
+}
+
+void Ponderer::start(const Board& board, const Move& ourMove, const Move& expectedReply, RootSearch search, int threads) {
+    stop();
+    if (expectedReply.from == -1 || expectedReply.to == -1) {
+        return;
+    }
+
+    // Play both moves the way the game loop does, so the position history the
+    // search checks for repetitions is the one the game will have
+    ponderBoard = std::make_unique<Board>(board);
+    ponderBoard->searchControl = &control;
+    Move move = ourMove;
+    ponderBoard->makeMove(move);
+    ponderBoard->lastMove = move;
+    ponderBoard->updatePositionHistory(true);
+    Move reply = expectedReply;
+    ponderBoard->makeMove(reply);
+    ponderBoard->lastMove = reply;
+    ponderBoard->updatePositionHistory(true);
+    ponderHash = ponderBoard->generateZobristHash();
+
+    // Started here rather than on the worker, so a stop() that comes before the
+    // worker gets going cannot be undone by it
+    control.start(0);
+    worker = std::thread([this, search, threads]() {
+        ponderResult = runLazySmpSearch(*ponderBoard, search, threads);
+        });
+}
+
+bool Ponderer::finish(Board& board, const SearchLimits& limits, SearchResult& result) {
+    if (!pondering()) {
+        return false;
+    }
+
+    bool hit = board.generateZobristHash() == ponderHash;
+    if (hit) {
+        int timeLimitMs = limits.remainingMs > 0
+            ? TimeManager(limits.remainingMs, limits.incrementMs, limits.movesToGo).softLimitMs()
+            : limits.timeMs;
+        control.ponderHit(timeLimitMs);
+    }
+    else {
+        control.stop();
+    }
+    worker.join();
+    keepHeuristics(board);
+
+    // A hit on a position without legal moves leaves nothing to play
+    if (!hit || ponderResult.bestMove.from == -1) {
+        return false;
+    }
+    result = ponderResult;
+    return true;
+}
+
+void Ponderer::stop() {
+    if (!pondering()) {
+        return;
+    }
+    control.stop();
+    worker.join();
+}
+
+void Ponderer::keepHeuristics(Board& board) const {
+    board.history = ponderBoard->history;
+    std::copy(&ponderBoard->killerMoves[0][0], &ponderBoard->killerMoves[0][0] + 2 * MAX_PLY, &board.killerMoves[0][0]);
+}
@@ -0,0 +1,51 @@
+#pragma once
+#ifndef PONDER_H
+#define PONDER_H
+
+#include "search.h"
+#include "searchcontrol.h"
+#include <memory>
+#include <thread>
+
+// Thinks on the opponent's time. After playing a move the engine searches the
+// position after the reply it expects, on a copy of the board with its own
+// SearchControl so the opponent can search on the game board meanwhile.
+// If the opponent plays the expected move (a ponder hit) the running search
+// becomes the real one and gets the normal time limit from then on, keeping
+// everything it has already searched. Otherwise the ponder search is stopped
+// and the caller searches the actual position, which still profits from the
+// table entries the ponder search left behind.
+class Ponderer {
+public:
+    Ponderer() = default;
+    ~Ponderer();
+
+    Ponderer(const Ponderer&) = delete;
+    Ponderer& operator=(const Ponderer&) = delete;
+
+    // Starts pondering on board after ourMove and the opponent's expectedReply,
+    // neither of which has been played on board yet. Does nothing if there is
+    // no expected reply.
+    void start(const Board& board, const Move& ourMove, const Move& expectedReply, RootSearch search, int threads);
+    // Call when it is our move on board again. On a ponder hit gives the search
+    // the time limits allow for the move, the soft limit when on a clock, and
+    // returns true with its result. Returns false after stopping the search on
+    // a miss, or if not pondering. Either way the history and killers learned
+    // while pondering are kept.
+    bool finish(Board& board, const SearchLimits& limits, SearchResult& result);
+    // Abandons the ponder search, for example when the game ends
+    void stop();
+
+    bool pondering() const { return worker.joinable(); }
+
+private:
+    void keepHeuristics(Board& board) const;
+
+    SearchControl control;
+    std::unique_ptr<Board> ponderBoard;
+    uint64_t ponderHash = 0;
+    SearchResult ponderResult;
+    std::thread worker;
+};
+
+#endif // PONDER_H
@@ -0,0 +1,14 @@
+#pragma once
+#ifndef POSITIONS_H
+#define POSITIONS_H
+
+#include <cstddef>
+
+// Test positions as EPD lines, FEN followed by the best move ("bm") or the
+// move to avoid ("am"). Engine matches start from them and bench searches
+// them. fenArray is also read by training/train_pcsq.py, keep its layout.
+extern const char* const fenArrayShort[15];
+extern const char* const fenArrayMedium[60];
+extern const char* const fenArray[111];
+
+#endif // POSITIONS_H
@@ -0,0 +1,224 @@
+#include "search.h"
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <thread>
+
+SearchParams searchParams;
+
+// Late move reductions by depth and move number, filled once at startup
+struct ReductionTable {
+    int reductions[64][64];
+
+    ReductionTable() {
+        for (int depth = 0; depth < 64; depth++) {
+            for (int moveNumber = 0; moveNumber < 64; moveNumber++) {
+                reductions[depth][moveNumber] = (depth == 0 || moveNumber == 0) ? 0
+                    : (int)(0.5 + std::log((double)depth) * std::log((double)moveNumber) / 2.0);
+            }
+        }
+    }
+};
+
+static const ReductionTable reductionTable;
+
+int lateMoveReduction(int depth, int moveNumber) {
+    return reductionTable.reductions[std::min(depth, 63)][std::min(moveNumber, 63)];
+}
+
+const int ASPIRATION_MIN_DEPTH = 4;
+const Score ASPIRATION_WINDOW = 30;
+
+// Runs iterative deepening on one thread until the search is stopped, reaches
+// maxDepth (at most MAX_DEPTH), finds a mate or the time manager (main thread only) calls it a
+// day. result holds the last fully searched depth, or a better move the
+// interrupted iteration finished searching. onIteration, if not null, is
+// called after every completed iteration.
+// From ASPIRATION_MIN_DEPTH on, each depth is first searched with a narrow
+// window around the previous score. The window doubles on the failing side
+// until the score lands inside it.
+static void iterativeDeepening(Board& board, RootSearch search, int firstDepth, int maxDepth, SearchResult& result, TimeManager* timeManager, const IterationCallback* onIteration) {
+    std::vector<std::tuple<Move, Score>> iterativeDeepeningMoves;
+    uint64_t nodesBefore = board.nodes;
+    Move bestMove;
+    Score bestScore;
+    maxDepth = std::min(maxDepth, MAX_DEPTH);
+    for (int depth = firstDepth; depth <= maxDepth; depth++) {
+#ifdef SEARCH_STATS
+        auto iterationStart = std::chrono::steady_clock::now();
+        SearchStats statsBefore = board.searchStats;
+        TTStats ttStatsBefore = board.ttStats;
+        uint64_t nodesBeforeIteration = board.nodes;
+#endif
+        Score delta = ASPIRATION_WINDOW;
+        Score alpha = -SCORE_INFINITE;
+        Score beta = SCORE_INFINITE;
+        if (depth >= ASPIRATION_MIN_DEPTH && result.depth > 0 && !isMateScore(result.score)) {
+            alpha = std::max(result.score - delta, -SCORE_INFINITE);
+            beta = std::min(result.score + delta, SCORE_INFINITE);
+        }
+
+        while (true) {
+            std::tie(bestMove, bestScore) = search(board, depth, iterativeDeepeningMoves, alpha, beta);
+            if (board.searchControl->stopped()) {
+                break;
+            }
+
+            delta += delta;
+            if (bestScore <= alpha && alpha > -SCORE_INFINITE) {
+                beta = (alpha + beta) / 2;
+                alpha = std::max(bestScore - delta, -SCORE_INFINITE);
+            }
+            else if (bestScore >= beta && beta < SCORE_INFINITE) {
+                beta = std::min(bestScore + delta, SCORE_INFINITE);
+            }
+            else {
+                break;
+            }
+        }
+
+        if (board.searchControl->stopped()) {
+            // The root only returns a move from an unfinished iteration when it
+            // beat the window, result.depth stays at the last complete one
+            if (bestMove.to != -1 && bestMove.from != -1) {
+                result.bestMove = bestMove;
+                result.score = bestScore;
+            }
+            break;
+        }
+        else if (bestMove.to != -1 && bestMove.from != -1) {
+            result.bestMove = bestMove;
+            result.score = bestScore;
+            result.depth = depth;
+#ifdef SEARCH_STATS
+            DepthStats stats;
+            stats.depth = depth;
+            stats.score = bestScore;
+            stats.bestMove = bestMove;
+            stats.elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - iterationStart).count();
+            stats.counters = board.searchStats.since(statsBefore);
+            stats.nodes = board.nodes - nodesBeforeIteration;
+            stats.ttProbes = board.ttStats.probes - ttStatsBefore.probes;
+            stats.ttHits = board.ttStats.hits - ttStatsBefore.hits;
+            result.iterations.push_back(stats);
+#endif
+            if (onIteration) {
+                result.nodes = board.nodes - nodesBefore;
+                (*onIteration)(result);
+            }
+            if (isMateScore(bestScore)) {
+                break;
+            }
+            if (timeManager && timeManager->stopAfterIteration(bestMove, bestScore)) {
+                break;
+            }
+        }
+    }
+}
+
+// The hash move of the position on board if it is legal there. Otherwise
+// NO_MOVE, or with anyMove the first legal move if there is one.
+static Move legalHashMove(Board& board, bool anyMove) {
+    std::vector<Move> moves = board.generateAllMoves();
+    uint64_t hash = board.generateZobristHash();
+    TT_Entry entry = board.probeTranspositionTable(hash);
+    if (entry.key == hash) {
+        for (const Move& move : moves) {
+            if (move.from == entry.move.from && move.to == entry.move.to && move.promotion == entry.move.promotion) {
+                return move;
+            }
+        }
+    }
+    return (anyMove && !moves.empty()) ? moves[0] : NO_MOVE;
+}
+
+// The reply the search expects to bestMove, the hash move of the position after
+// it if that is legal there. This is the move to ponder on.
+static Move expectedReply(Board& board, Move bestMove) {
+    if (bestMove.from == -1 || bestMove.to == -1) {
+        return NO_MOVE;
+    }
+
+    Bitboard enPassantStore = board.enPassantTarget;
+    bool whiteKingMovedStore = board.whiteKingMoved;
+    bool whiteLRookMovedStore = board.whiteLRookMoved;
+    bool whiteRRookMovedStore = board.whiteRRookMoved;
+    bool blackKingMovedStore = board.blackKingMoved;
+    bool blackLRookMovedStore = board.blackLRookMoved;
+    bool blackRRookMovedStore = board.blackRRookMoved;
+    board.makeMove(bestMove);
+
+    Move reply = legalHashMove(board, false);
+
+    board.enPassantTarget = enPassantStore;
+    board.whiteKingMoved = whiteKingMovedStore;
+    board.whiteLRookMoved = whiteLRookMovedStore;
+    board.whiteRRookMoved = whiteRRookMovedStore;
+    board.blackKingMoved = blackKingMovedStore;
+    board.blackLRookMoved = blackLRookMovedStore;
+    board.blackRRookMoved = blackRRookMovedStore;
+    board.undoMove(bestMove);
+    return reply;
+}
+
+// Lazy SMP: the helpers run the same iterative deepening as the main thread on
+// their own copy of the board, so they have their own killers and position
+// history but share the transposition table. Every other helper starts one
+// ply deeper so the threads do not all finish the same depths in lockstep.
+// Only the main thread's result is reported, the helpers contribute by
+// filling the table with entries the main thread can cut off on.
+SearchResult lazySmpSearch(Board& board, RootSearch search, int threads, int timeLimitMs, int maxDepth) {
+    board.searchControl->start(timeLimitMs);
+    return runLazySmpSearch(board, search, threads, maxDepth);
+}
+
+SearchResult lazySmpSearch(Board& board, RootSearch search, int threads, const SearchLimits& limits) {
+    std::unique_ptr<TimeManager> timeManager = startSearchControl(board, limits);
+    return runLazySmpSearch(board, search, limits.nodes > 0 ? 1 : threads, limits.depth, timeManager.get());
+}
+
+std::unique_ptr<TimeManager> startSearchControl(Board& board, const SearchLimits& limits) {
+    int timeLimitMs = limits.timeMs;
+    std::unique_ptr<TimeManager> timeManager;
+    if (limits.remainingMs > 0) {
+        timeManager = std::make_unique<TimeManager>(limits.remainingMs, limits.incrementMs, limits.movesToGo);
+        timeLimitMs = timeManager->hardLimitMs();
+    }
+    // checkNodes is given the main board's running count, so the limit is offset by it
+    board.searchControl->start(timeLimitMs, limits.nodes > 0 ? board.nodes + limits.nodes : 0);
+    return timeManager;
+}
+
+SearchResult runLazySmpSearch(Board& board, RootSearch search, int threads, int maxDepth, TimeManager* timeManager, const IterationCallback& onIteration) {
+    // Played if the search is stopped before it completes a root move
+    SearchResult result;
+    result.bestMove = legalHashMove(board, true);
+
+    board.history.age();
+    // Before the helper boards are copied, so they store the same generation
+    board.newTTGeneration();
+    uint64_t nodesBefore = board.nodes;
+
+    std::vector<Board> helperBoards(std::max(threads - 1, 0), board);
+    std::vector<SearchResult> helperResults(helperBoards.size());
+    std::vector<std::thread> helpers;
+    for (size_t i = 0; i < helperBoards.size(); i++) {
+        helperBoards[i].ttStats = TTStats();
+        helperBoards[i].nodes = 0;
+        helpers.emplace_back(iterativeDeepening, std::ref(helperBoards[i]), search, 1 + (int)(i % 2), MAX_DEPTH, std::ref(helperResults[i]), nullptr, nullptr);
+    }
+
+    iterativeDeepening(board, search, 1, maxDepth, result, timeManager, onIteration ? &onIteration : nullptr);
+
+    board.searchControl->stop();
+    for (std::thread& helper : helpers) {
+        helper.join();
+    }
+
+    result.nodes = board.nodes - nodesBefore;
+    for (const Board& helperBoard : helperBoards) {
+        result.nodes += helperBoard.nodes;
+    }
+    result.ponderMove = expectedReply(board, result.bestMove);
+    return result;
+}
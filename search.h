@@ -0,0 +1,578 @@
+#pragma once
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include "bitbase.h"
+#include "chess.h"
+#include "movepick.h"
+#include "searchcontrol.h"
+#include "searchstats.h"
+#include "timemanager.h"
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+// Shallow-depth forward pruning. None of the rules apply at the root or when
+// the side to move is in check, and all but SEE pruning also leave PV nodes
+// alone. Each can be switched off on its own to measure what it is worth.
+// Margins are in centipawns, "per ply" margins are multiplied by the
+// remaining depth.
+struct SearchParams {
+    // Static eval so far above beta that the node is assumed to fail high
+    bool reverseFutility = true;
+    int reverseFutilityDepth = 6;
+    Score reverseFutilityMargin = 90;   // per ply
+
+    // Static eval so far below alpha that only qsearch could save the node
+    bool razoring = true;
+    int razoringDepth = 2;
+    Score razoringMargin = 250;         // per ply
+
+    // Quiet moves that do not give check are skipped when static eval plus
+    // the margin stays below alpha. Off by default, it lost equal-time
+    // matches with margins from 120 to 200.
+    bool futility = false;
+    int futilityDepth = 3;
+    Score futilityMargin = 120;         // per ply
+
+    // Quiet moves that do not give check are skipped once
+    // lateMoveBase + depth * depth moves have been tried
+    bool lateMovePruning = true;
+    int lateMovePruningDepth = 3;
+    int lateMoveBase = 4;
+
+    // Quiet moves that lose more than the margin by static exchange evaluation
+    bool seeQuietPruning = true;
+    int seeQuietPruningDepth = 3;
+    Score seeQuietMargin = 80;          // per ply
+
+    // Late move reductions start at this depth and move number (counted from 0)
+    int lateMoveReductionDepth = 3;
+    int lateMoveReductionMoves = 2;
+    // History score worth one ply less (or more) reduction
+    int lateMoveReductionHistory = 16384;
+
+    // Null move R is nullMoveBase + depth / nullMoveDepthDivisor, plus one per
+    // nullMoveEvalDivisor the static eval is above beta, up to nullMoveEvalMax
+    int nullMoveBase = 2;
+    int nullMoveDepthDivisor = 4;
+    Score nullMoveEvalDivisor = 200;
+    int nullMoveEvalMax = 2;
+    // From this depth a null move cutoff is confirmed by a reduced search
+    // without null move, which catches zugzwang
+    int nullMoveVerifyDepth = 8;
+};
+
+// Base late move reduction in plies for a move number (counted from 1) at a
+// depth, growing with the logarithm of both
+int lateMoveReduction(int depth, int moveNumber);
+
+// Read by both engines unless the board belongs to an Engine with its own,
+// change it only while no search is running
+extern SearchParams searchParams;
+
+// Kind of node, fixed at compile time so that each gets its own copy of the
+// search: the root handles the move list kept between iterations, PV nodes
+// are searched with an open window and NonPV nodes, nearly all of the tree,
+// with a null window and none of the work the other two need.
+enum class NodeType { Root, PV, NonPV };
+
+// Alpha-beta search shared by both engines. The evaluator is a policy class
+// with a single `static Score evaluate(Board&)`, so each engine gets its own
+// specialization of the same search with its evaluation inlined, and engine
+// comparisons only differ in evaluation.
+template <typename Evaluator>
+class Search {
+public:
+    // Searches the root to depth. iterativeDeepeningMoves holds the root moves
+    // sorted by the previous iteration and is replaced with this one's order.
+    // If the search is stopped the move is Move() unless one root move was
+    // searched completely and scored above alpha.
+    static std::tuple<Move, Score> root(Board& board, int depth, std::vector<std::tuple<Move, Score>>& iterativeDeepeningMoves, Score alpha, Score beta) {
+        return node<NodeType::Root>(board, depth, alpha, beta, iterativeDeepeningMoves, 0, false, 0);
+    }
+
+private:
+    static Score quiescence(Board& board, Score alpha, Score beta, int ply);
+    // iterativeDeepeningMoves is only read and written by the root
+    template <NodeType nodeType>
+    static std::tuple<Move, Score> node(Board& board, int depth, Score alpha, Score beta, std::vector<std::tuple<Move, Score>>& iterativeDeepeningMoves, int totalExtensions, bool lastIterationNull, int ply);
+};
+
+template <typename Evaluator>
+Score Search<Evaluator>::quiescence(Board& board, Score alpha, Score beta, int ply) {
+    const Score QS_DELTA_MARGIN = 200;
+    board.nodes++;
+    board.searchControl->checkNodes(board.nodes);
+    SEARCH_STAT(board, qnodes);
+
+    if (ply >= MAX_PLY - 1) {
+        return Evaluator::evaluate(board);
+    }
+
+    // Known endgames are looked up instead of evaluated
+    Score bitbaseScore;
+    if (probeBitbase(board, ply, bitbaseScore)) {
+        return bitbaseScore;
+    }
+
+    uint64_t hash = board.generateZobristHash();
+    TT_Entry ttEntry = board.probeTranspositionTable(hash);
+
+    // Any stored entry was searched at least as deep as a quiescence search
+    if (ttEntry.key == hash) {
+        Score ttScore = scoreFromTT(ttEntry.score, ply);
+        if (ttEntry.flag == TTFlag::HASH_FLAG_EXACT ||
+            (ttEntry.flag == TTFlag::HASH_FLAG_LOWER && ttScore >= beta) ||
+            (ttEntry.flag == TTFlag::HASH_FLAG_UPPER && ttScore <= alpha)) {
+            board.recordTTCutoff(ttEntry.flag);
+            return ttScore;
+        }
+    }
+
+    Score alphaOrig = alpha;
+    Score bestScore;
+    Score stand_pat = 0;
+    bool inCheck = board.amIInCheck(board.whiteToMove);
+    std::vector<Move> moves;
+    if (inCheck) {
+        // No standing pat in check, every legal move is searched and having none is mate
+        moves = board.generateAllMoves();
+        if (moves.empty()) {
+            return matedIn(ply);
+        }
+        bestScore = -SCORE_INFINITE;
+    }
+    else {
+        stand_pat = Evaluator::evaluate(board);
+        if (stand_pat >= beta) {
+            board.record_tt_entry(hash, scoreToTT(stand_pat, ply), HASH_FLAG_LOWER, NO_MOVE, 0);
+            return stand_pat;
+        }
+        if (alpha < stand_pat) {
+            alpha = stand_pat;
+        }
+        bestScore = stand_pat;
+        moves = board.generateCaptures();
+    }
+    Move bestMove;
+    MovePicker picker(board, moves, ttEntry.key == hash ? &ttEntry : nullptr, 0, ply);
+
+    Score subBestScore = -SCORE_INFINITE;
+    Bitboard store = board.enPassantTarget;
+    bool whiteKingMovedStore = board.whiteKingMoved;
+    bool whiteLRookMovedStore = board.whiteLRookMoved;
+    bool whiteRRookMovedStore = board.whiteRRookMoved;
+    bool blackKingMovedStore = board.blackKingMoved;
+    bool blackLRookMovedStore = board.blackLRookMoved;
+    bool blackRRookMovedStore = board.blackRRookMoved;
+
+    // Outside of check only captures are searched here, and a position after a
+    // capture can never repeat one from before it, so there is no repetition check
+    Move move;
+    while (picker.next(move)) {
+        if (!inCheck) {
+            // Losing captures come last, none of the rest can raise the stand pat score
+            if (picker.losingCapture()) {
+                break;
+            }
+            // Delta pruning: even winning the captured piece outright and a margin
+            // for positional gains would leave us below alpha
+            if (!move.promotion && stand_pat + getPieceValue(move.capturedPiece) * 100 + QS_DELTA_MARGIN <= alpha) {
+                continue;
+            }
+        }
+
+        board.makeMove(move);
+        // Captures are generated without a legality check, evasions already had one
+        bool legal = inCheck || !board.amIInCheck(!board.whiteToMove);
+        if (legal) {
+            subBestScore = -quiescence(board, -beta, -alpha, ply + 1);
+        }
+
+        board.enPassantTarget = store;
+        board.whiteKingMoved = whiteKingMovedStore;
+        board.whiteLRookMoved = whiteLRookMovedStore;
+        board.whiteRRookMoved = whiteRRookMovedStore;
+        board.blackKingMoved = blackKingMovedStore;
+        board.blackLRookMoved = blackLRookMovedStore;
+        board.blackRRookMoved = blackRRookMovedStore;
+        board.undoMove(move);
+        if (!legal) {
+            continue;
+        }
+
+        if (subBestScore >= beta) {
+            board.record_tt_entry(hash, scoreToTT(subBestScore, ply), HASH_FLAG_LOWER, move, 0);
+            return subBestScore;
+        }
+        if (subBestScore > bestScore) {
+            bestScore = subBestScore;
+            bestMove = move;
+        }
+        if (bestScore > alpha) {
+            alpha = bestScore;
+        }
+    }
+
+    TTFlag flag = (bestScore <= alphaOrig) ? HASH_FLAG_UPPER : HASH_FLAG_EXACT;
+    board.record_tt_entry(hash, scoreToTT(bestScore, ply), flag, bestMove, 0);
+    return bestScore;
+}
+
+template <typename Evaluator>
+template <NodeType nodeType>
+std::tuple<Move, Score> Search<Evaluator>::node(Board& board, int depth, Score alpha, Score beta, std::vector<std::tuple<Move, Score>>& iterativeDeepeningMoves, int totalExtensions, bool lastIterationNull, int ply) {
+    constexpr bool rootNode = nodeType == NodeType::Root;
+    constexpr bool pvNode = nodeType != NodeType::NonPV;
+    // Children searched with the window of this node, null windows are always NonPV
+    constexpr NodeType fullWindowChild = pvNode ? NodeType::PV : NodeType::NonPV;
+
+    if (board.searchControl->stopped()) {
+        return { Move(), SCORE_DRAW };
+    }
+    // Leaves go straight to quiescence, which only generates the moves it
+    // searches and counts the node itself
+    if (depth <= 0) {
+        return { Move(), quiescence(board, alpha, beta, ply) };
+    }
+    board.nodes++;
+    board.searchControl->checkNodes(board.nodes);
+    SEARCH_STAT(board, nodes);
+
+    // Below the root, known endgames need no search at all
+    Score bitbaseScore;
+    if (!rootNode && probeBitbase(board, ply, bitbaseScore)) {
+        return { Move(), bitbaseScore };
+    }
+
+    const int MAX_EXTENSIONS = 3;
+    const SearchParams& params = board.searchParams ? *board.searchParams : searchParams;
+    int extension = 0;
+
+    uint64_t hash = board.generateZobristHash();
+    TT_Entry ttEntry = board.probeTranspositionTable(hash);
+
+    // Only zero-window nodes trust a stored score. The root and PV nodes search
+    // on, so the root move list and the PV come from this search and not from
+    // an older one or another thread's.
+    if (!pvNode && ttEntry.key == hash && ttEntry.depth >= depth) {
+        Score ttScore = scoreFromTT(ttEntry.score, ply);
+        if (ttEntry.flag == TTFlag::HASH_FLAG_EXACT ||
+            (ttEntry.flag == TTFlag::HASH_FLAG_LOWER && ttScore >= beta) ||
+            (ttEntry.flag == TTFlag::HASH_FLAG_UPPER && ttScore <= alpha)) {
+            board.recordTTCutoff(ttEntry.flag);
+            return { ttEntry.move, ttScore };
+        }
+    }
+
+    // The window may narrow while searching, the stored bound depends on the one we were given
+    Score alphaOrig = alpha;
+
+    std::vector<Move> moves;
+    if (rootNode && !iterativeDeepeningMoves.empty()) {
+        // Extract moves from the tuples for use in this depth
+        std::transform(iterativeDeepeningMoves.begin(), iterativeDeepeningMoves.end(), std::back_inserter(moves),
+            [](const std::tuple<Move, Score>& pair) { return std::get<0>(pair); });
+    }
+    else {
+        moves = board.generateAllMoves();
+        if (moves.empty()) {
+            if (board.amIInCheck(board.whiteToMove)) {
+                return { Move(), matedIn(ply) }; // checkmate
+            }
+            else {
+                return { Move(), SCORE_DRAW }; // stalemate
+            }
+        }
+    }
+
+    bool inCheck = board.amIInCheck(board.whiteToMove);
+    bool canPrune = !inCheck && !pvNode;
+    Score staticEval = inCheck ? -SCORE_INFINITE : Evaluator::evaluate(board);
+    // Better than two plies ago, when the same side was to move
+    bool improving = false;
+    if (ply < MAX_PLY) {
+        board.searchStack[ply].staticEval = staticEval;
+        improving = !inCheck && ply >= 2 && staticEval > board.searchStack[ply - 2].staticEval;
+    }
+
+    // Reverse futility pruning
+    if (canPrune && params.reverseFutility && depth <= params.reverseFutilityDepth
+        && staticEval - params.reverseFutilityMargin * depth >= beta && !isMateScore(beta)) {
+        return { Move(), staticEval };
+    }
+
+    // Razoring: drop into qsearch, and trust it if it cannot reach alpha either
+    if (canPrune && params.razoring && depth <= params.razoringDepth
+        && staticEval + params.razoringMargin * depth < alpha) {
+        Score razorScore = quiescence(board, alpha, alpha + 1, ply);
+        if (razorScore <= alpha) {
+            return { Move(), razorScore };
+        }
+    }
+
+    Bitboard store = board.enPassantTarget;
+    bool whiteKingMovedStore = board.whiteKingMoved;
+    bool whiteLRookMovedStore = board.whiteLRookMoved;
+    bool whiteRRookMovedStore = board.whiteRRookMoved;
+    bool blackKingMovedStore = board.blackKingMoved;
+    bool blackLRookMovedStore = board.blackLRookMoved;
+    bool blackRRookMovedStore = board.blackRRookMoved;
+
+    // Null Move Pruning, only in null-window nodes (pvNode includes the root)
+    if (!pvNode && !inCheck && depth > 2 && isNullViable(board) && !lastIterationNull) {
+        SEARCH_STAT(board, nullMoveTries);
+        board.recordSearchMove(ply, NO_MOVE);
+        board.makeNullMove();
+        // Reduce more at higher depth and the further the static eval is above beta
+        int R = params.nullMoveBase + depth / params.nullMoveDepthDivisor;
+        if (staticEval > beta) {
+            R += std::min((staticEval - beta) / params.nullMoveEvalDivisor, params.nullMoveEvalMax);
+        }
+        int nullDepth = std::max(depth - 1 - R, 0);
+        std::tuple<Move, Score> result = node<NodeType::NonPV>(board, nullDepth, -beta, -beta + 1, iterativeDeepeningMoves, totalExtensions, true, ply + 1);
+        board.undoNullMove();
+        // undoNullMove restores from a single saved copy, which a null move
+        // deeper in the subtree has overwritten
+        board.enPassantTarget = store;
+        board.whiteKingMoved = whiteKingMovedStore;
+        board.whiteLRookMoved = whiteLRookMovedStore;
+        board.whiteRRookMoved = whiteRRookMovedStore;
+        board.blackKingMoved = blackKingMovedStore;
+        board.blackLRookMoved = blackLRookMovedStore;
+        board.blackRRookMoved = blackRRookMovedStore;
+        if (board.searchControl->stopped()) {
+            return { Move(), SCORE_DRAW };
+        }
+        Score nullMoveEvaluation = -std::get<1>(result);
+
+        // null move cutoff
+        if (nullMoveEvaluation >= beta) {
+            if (depth < params.nullMoveVerifyDepth) {
+                SEARCH_STAT(board, nullMoveCutoffs);
+                return { Move(), beta }; // Cutoff
+            }
+            // Verify with this side moving after all, lastIterationNull keeps
+            // the verification from trying a null move itself
+            std::tuple<Move, Score> verification = node<NodeType::NonPV>(board, nullDepth, beta - 1, beta, iterativeDeepeningMoves, totalExtensions, true, ply);
+            if (board.searchControl->stopped()) {
+                return { Move(), SCORE_DRAW };
+            }
+            if (std::get<1>(verification) >= beta) {
+                SEARCH_STAT(board, nullMoveCutoffs);
+                return { Move(), beta };
+            }
+        }
+
+        // mate threat extension
+        if (totalExtensions < MAX_EXTENSIONS) {
+            if (nullMoveEvaluation + 100 <= alpha) {
+                extension = 1;
+            }
+        }
+    }
+
+    Move bestMove;
+    Score bestScore = -SCORE_INFINITE;
+    Score subBestScore = -SCORE_INFINITE;
+    Move subBestMove;
+    std::vector<std::tuple<Move, Score>> moveScores;
+    Move quietsSearched[64];
+    int quietCount = 0;
+
+    MovePicker picker = (rootNode && !iterativeDeepeningMoves.empty())
+        ? MovePicker(moves)
+        : MovePicker(board, moves, ttEntry.key == hash ? &ttEntry : nullptr, depth, ply);
+    Move move;
+    for (int i = 0; picker.next(move); i++) {
+        bool quiet = !move.isCapture && !move.promotion;
+        bool reduce = quiet && extension == 0 && !inCheck && depth >= params.lateMoveReductionDepth && i >= params.lateMoveReductionMoves;
+        // Read before makeMove, the history is keyed by the piece on the from square
+        int historyScore = reduce ? board.quietMoveScore(move, ply) : 0;
+        // Near the leaves, skip quiet moves that hand the opponent material
+        if (params.seeQuietPruning && i > 0 && depth <= params.seeQuietPruningDepth && !inCheck && !rootNode && quiet
+            && board.see(move) < -params.seeQuietMargin * depth) {
+            continue;
+        }
+        board.recordSearchMove(ply, move);
+        board.makeMove(move);
+
+        // Futility and late move pruning, only once a move has been searched
+        // and it did not lead to being mated
+        bool pruned = false;
+        if (canPrune && quiet && i > 0 && bestScore > -SCORE_MATE_IN_MAX_PLY && !board.amIInCheck(board.whiteToMove)) {
+            pruned = (params.futility && depth <= params.futilityDepth && staticEval + params.futilityMargin * depth <= alpha)
+                || (params.lateMovePruning && depth <= params.lateMovePruningDepth && i >= params.lateMoveBase + depth * depth);
+        }
+
+        if (pruned) {
+            // Skipped, the board is restored below
+        }
+        else if (!board.isThreefoldRepetition()) {
+            bool needsFullSearch = true;
+            // Lets do a reduced depth search for the less promising moves
+            if (reduce) {
+                int depthReduction = lateMoveReduction(depth, i + 1);
+                if (pvNode) {
+                    depthReduction--;
+                }
+                if (!improving) {
+                    depthReduction++;
+                }
+                depthReduction -= historyScore / params.lateMoveReductionHistory;
+                // Never drop into qsearch. With no reduction left the move just
+                // gets the ordinary null-window search below.
+                depthReduction = std::max(0, std::min(depthReduction, depth - 2));
+
+                if (depthReduction > 0) {
+                    SEARCH_STAT(board, reducedSearches);
+                    std::tie(subBestMove, subBestScore) = node<NodeType::NonPV>(board, depth - 1 - depthReduction, -alpha - 1, -alpha, iterativeDeepeningMoves, totalExtensions, false, ply + 1);
+                    subBestScore = -subBestScore;
+
+                    needsFullSearch = subBestScore > alpha;
+                    if (needsFullSearch) {
+                        SEARCH_STAT(board, reSearches);
+                    }
+                }
+            }
+
+            // Principal variation search: after the first move we only need to show
+            // that a move is no better than alpha, which a null window does cheaply.
+            // Moves that beat it are searched again with the real window.
+            if (needsFullSearch && i > 0) {
+                std::tie(subBestMove, subBestScore) = node<NodeType::NonPV>(board, depth - 1 + extension, -alpha - 1, -alpha, iterativeDeepeningMoves, totalExtensions + extension, false, ply + 1);
+                subBestScore = -subBestScore;
+
+                needsFullSearch = subBestScore > alpha && subBestScore < beta;
+            }
+
+            if (needsFullSearch) {
+                std::tie(subBestMove, subBestScore) = node<fullWindowChild>(board, depth - 1 + extension, -beta, -alpha, iterativeDeepeningMoves, totalExtensions + extension, false, ply + 1);
+                subBestScore = -subBestScore;
+            }
+        }
+        else {
+            subBestScore = SCORE_DRAW;
+        }
+        board.enPassantTarget = store;
+        board.whiteKingMoved = whiteKingMovedStore;
+        board.whiteLRookMoved = whiteLRookMovedStore;
+        board.whiteRRookMoved = whiteRRookMovedStore;
+        board.blackKingMoved = blackKingMovedStore;
+        board.blackLRookMoved = blackLRookMovedStore;
+        board.blackRRookMoved = blackRRookMovedStore;
+        board.undoMove(move);
+
+        // Abandon the node, the partial result must not reach the table. The root
+        // still reports its best move if that was searched to the end and beat
+        // alpha, which makes it at least as good as the last iteration's move.
+        if (board.searchControl->stopped()) {
+            if (rootNode && bestScore > alphaOrig) {
+                return { bestMove, bestScore };
+            }
+            return { Move(), SCORE_DRAW };
+        }
+        if (pruned) {
+            continue;
+        }
+
+        if (rootNode) {
+            moveScores.emplace_back(move, subBestScore);
+        }
+
+        if (subBestScore >= beta) {
+            SEARCH_STAT(board, betaCutoffs);
+            if (i == 0) {
+                SEARCH_STAT(board, firstMoveCutoffs);
+            }
+            if (quiet) {
+                // Record the killer move if it isnt a capture
+                if (board.killerMoves[0][ply] != move && board.killerMoves[1][ply] != move) {
+                    board.killerMoves[1][ply] = board.killerMoves[0][ply];
+                    board.killerMoves[0][ply] = move;
+                }
+                board.updateQuietHistory(move, quietsSearched, quietCount, depth, ply);
+            }
+            board.record_tt_entry(hash, scoreToTT(subBestScore, ply), HASH_FLAG_LOWER, move, depth);
+            return { move, subBestScore };
+        }
+
+        if (quiet && quietCount < 64) {
+            quietsSearched[quietCount++] = move;
+        }
+
+        if (subBestScore > bestScore) {
+            bestScore = subBestScore;
+            bestMove = move;
+        }
+
+        if (bestScore > alpha) {
+            alpha = bestScore;
+        }
+    }
+
+    if (rootNode) {
+        // Sort moves based on scores for next iterative deepening step
+        std::sort(moveScores.begin(), moveScores.end(), [](const std::tuple<Move, Score>& a, const std::tuple<Move, Score>& b) {
+            return std::get<1>(a) > std::get<1>(b); // Sort descending by score
+            });
+        iterativeDeepeningMoves = moveScores; // Update iterativeDeepeningMoves for next iteration
+    }
+
+    TTFlag flag = (bestScore <= alphaOrig) ? HASH_FLAG_UPPER : HASH_FLAG_EXACT;
+    board.record_tt_entry(hash, scoreToTT(bestScore, ply), flag, bestMove, depth);
+
+    return { bestMove, bestScore };
+}
+
+// Root search of either engine, engine() or perft2()
+typedef std::tuple<Move, Score> (*RootSearch)(Board& board, int depth, std::vector<std::tuple<Move, Score>>& iterativeDeepeningMoves, Score alpha, Score beta);
+
+struct SearchResult {
+    Move bestMove;        // Move() only when there is no legal move
+    Score score = 0;
+    int depth = 0;        // Last depth the main thread completed
+    uint64_t nodes = 0;   // Nodes searched by all threads together
+    Move ponderMove;      // Expected reply to bestMove, NO_MOVE if unknown
+    std::vector<DepthStats> iterations;  // Main thread, only with SEARCH_STATS
+};
+
+// Called on the main search thread after each iteration it completes, with
+// the result so far. Its nodes are the main thread's alone, the helpers'
+// counts are only added up once they have stopped.
+typedef std::function<void(const SearchResult& result)> IterationCallback;
+
+// When a search stops, whichever limit is reached first. Time varies with
+// machine load, while a depth or node limit searched on one thread plays the
+// same move every time for the same position and table contents.
+struct SearchLimits {
+    int timeMs = 0;       // 0 for no time limit
+    int depth = MAX_DEPTH;  // Capped at MAX_DEPTH
+    uint64_t nodes = 0;   // 0 for no node limit, counted like SearchResult::nodes (Board::nodes)
+
+    // Playing on a clock. With remainingMs set a TimeManager decides how long
+    // to search and timeMs is ignored.
+    int remainingMs = 0;
+    int incrementMs = 0;
+    int movesToGo = 0;    // 0 when the remaining time is for the rest of the game
+};
+
+// Searches for up to timeLimitMs milliseconds, a limit of 0 searches until maxDepth
+SearchResult lazySmpSearch(Board& board, RootSearch search, int threads, int timeLimitMs, int maxDepth = MAX_DEPTH);
+// A node limit is only reproducible on one thread, so with one the helpers
+// are left out whatever threads says
+SearchResult lazySmpSearch(Board& board, RootSearch search, int threads, const SearchLimits& limits);
+// Starts board.searchControl with the limits and, when they are a clock,
+// returns the TimeManager to hand to runLazySmpSearch
+std::unique_ptr<TimeManager> startSearchControl(Board& board, const SearchLimits& limits);
+// Same search without starting board.searchControl, for a caller that has
+// already started it and stops it or calls ponderHit from another thread.
+// With a timeManager the main thread asks it after each iteration whether to
+// go on, and onIteration, if set, is told about each one.
+SearchResult runLazySmpSearch(Board& board, RootSearch search, int threads, int maxDepth = MAX_DEPTH, TimeManager* timeManager = nullptr, const IterationCallback& onIteration = nullptr);
+
+#endif // SEARCH_H
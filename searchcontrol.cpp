@@ -0,0 +1,57 @@
+#include "searchcontrol.h"
+#include <chrono>
+
+SearchControl searchControl;
+
+SearchControl::~SearchControl() {
+    cancelTimer();
+}
+
+void SearchControl::start(int timeLimitMs, uint64_t nodeLimit) {
+    std::lock_guard<std::mutex> lock(controlMutex);
+    cancelTimer();
+    this->nodeLimit = nodeLimit > 0 ? nodeLimit : UINT64_MAX;
+    stopFlag = false;
+    armTimer(timeLimitMs);
+}
+
+void SearchControl::ponderHit(int timeLimitMs) {
+    std::lock_guard<std::mutex> lock(controlMutex);
+    cancelTimer();
+    if (!stopped()) {
+        armTimer(timeLimitMs);
+    }
+}
+
+void SearchControl::armTimer(int timeLimitMs) {
+    if (timeLimitMs <= 0) {
+        return;
+    }
+
+    timerCancelled = false;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeLimitMs);
+    timer = std::thread([this, deadline]() {
+        std::unique_lock<std::mutex> lock(timerMutex);
+        if (!timerWake.wait_until(lock, deadline, [this]() { return timerCancelled; })) {
+            stopFlag = true;
+        }
+        });
+}
+
+void SearchControl::stop() {
+    std::lock_guard<std::mutex> lock(controlMutex);
+    stopFlag = true;
+    cancelTimer();
+}
+
+void SearchControl::cancelTimer() {
+    if (!timer.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(timerMutex);
+        timerCancelled = true;
+    }
+    timerWake.notify_one();
+    timer.join();
+}
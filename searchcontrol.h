@@ -0,0 +1,61 @@
+#pragma once
+#ifndef SEARCHCONTROL_H
+#define SEARCHCONTROL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+// Tells a running search when to give up. A timer thread raises the stop flag
+// at the deadline, so the search only reads an atomic bool at each node
+// instead of querying the clock. Once stopped() is true every node returns
+// straight away without touching the transposition table, and the root
+// discards the unfinished iteration. A node limit raises the same flag from
+// the search itself, which unlike the clock gives the same result every run.
+class SearchControl {
+public:
+    SearchControl() = default;
+    ~SearchControl();
+
+    SearchControl(const SearchControl&) = delete;
+    SearchControl& operator=(const SearchControl&) = delete;
+
+    // Clears the stop flag and, for a positive limit, arms the timer. A nonzero
+    // nodeLimit is the node count at which checkNodes stops the search.
+    void start(int timeLimitMs, uint64_t nodeLimit = 0);
+    // Arms the timer of a search started without a limit, once a ponder search
+    // becomes the real one. Does nothing if the search was already stopped.
+    void ponderHit(int timeLimitMs);
+    // Raises the stop flag and cancels the timer. Must not be called from the
+    // timer thread. start, ponderHit and stop may come from different threads,
+    // for example a stop command while the search stops itself.
+    void stop();
+
+    bool stopped() const { return stopFlag.load(std::memory_order_relaxed); }
+    // Called at every node with the searching board's node count
+    void checkNodes(uint64_t nodes) {
+        if (nodes >= nodeLimit) {
+            stopFlag.store(true, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    void cancelTimer();
+    void armTimer(int timeLimitMs);
+
+    std::atomic<bool> stopFlag{ false };
+    uint64_t nodeLimit = UINT64_MAX;
+    std::mutex controlMutex;    // Held by start, ponderHit and stop
+    std::thread timer;
+    std::mutex timerMutex;
+    std::condition_variable timerWake;
+    bool timerCancelled = false;
+};
+
+// Used by every Board unless it is given its own. Both engines share it in a
+// game because they take turns, only a ponder search needs a separate one.
+extern SearchControl searchControl;
+
+#endif // SEARCHCONTROL_H
@@ -0,0 +1,66 @@
+#include "searchengine.h"
+#include <algorithm>
+
+Engine::Engine(RootSearch rootSearch, uint64_t hashMb)
+    : rootSearch(rootSearch), params(searchParams), tables(defaultPieceSquareTables) {
+    // The board's own table is already a new one, only the searches and
+    // evaluations on it have to be pointed at this engine
+    position.searchControl = &control;
+    position.searchParams = &params;
+    position.pieceSquareTables = &tables;
+    position.configureTranspositionTableSize(hashMb);
+    setPosition();
+}
+
+void Engine::newGame() {
+    position.clear_tt();
+    position.history.clear();
+    std::fill(&position.killerMoves[0][0], &position.killerMoves[0][0] + 2 * MAX_PLY, Move());
+}
+
+void Engine::setPosition() {
+    position.createBoard();
+    position.lastMove = Move();
+    position.positionHistory.clear();
+    position.updatePositionHistory(true);
+}
+
+void Engine::setPosition(const std::string& fen) {
+    position.createBoardFromFEN(fen);
+    position.lastMove = Move();
+    position.positionHistory.clear();
+    position.updatePositionHistory(true);
+}
+
+bool Engine::playMove(const std::string& text) {
+    for (const Move& move : position.generateAllMoves()) {
+        if (moveToString(move) == text) {
+            playMove(move);
+            return true;
+        }
+    }
+    return false;
+}
+
+void Engine::playMove(Move move) {
+    position.makeMove(move);
+    position.lastMove = move;
+    position.updatePositionHistory(true);
+}
+
+SearchResult Engine::search(const SearchLimits& limits) {
+    start(limits);
+    return run();
+}
+
+void Engine::start(const SearchLimits& limits) {
+    this->limits = limits;
+    timeManager = startSearchControl(position, limits);
+}
+
+SearchResult Engine::run() {
+    // A node limit is only reproducible on one thread, as in lazySmpSearch
+    SearchResult result = runLazySmpSearch(position, rootSearch, limits.nodes > 0 ? 1 : threads, limits.depth, timeManager.get(), onIteration);
+    timeManager.reset();
+    return result;
+}
@@ -0,0 +1,71 @@
+#pragma once
+#ifndef SEARCHENGINE_H
+#define SEARCHENGINE_H
+
+#include "chess.h"
+#include "engine.h"
+#include "search.h"
+#include "searchcontrol.h"
+#include <memory>
+#include <string>
+
+// One engine and everything its searches read and write: the root search and
+// with it the evaluation, the search parameters, the piece-square tables, the
+// position with its transposition table, killers and history, and the stop
+// flag. Engines share only what never changes once built (Zobrist keys,
+// opening book, endgame tables), so any number of them can search at the same
+// time in one process, each on its own thread. Each engine runs one search
+// at a time.
+class Engine {
+public:
+    // Starts from the global searchParams and piece-square tables, so
+    // settings made before inherit to the engine
+    explicit Engine(RootSearch rootSearch = engine, uint64_t hashMb = 64);
+
+    Engine(const Engine&) = delete;
+    Engine& operator=(const Engine&) = delete;
+
+    // Change these only while the engine is not searching
+    RootSearch rootSearch;
+    SearchParams params;
+    PieceSquareTables tables;
+    int threads = 1;
+    // Told about every iteration the search completes, on the search thread
+    IterationCallback onIteration;
+
+    bool loadTables(const std::string& path) { return loadPieceSquareTables(path, tables); }
+    void setHashSize(uint64_t mb) { position.configureTranspositionTableSize(mb); }
+    // Forgets the table entries, history and killers of earlier searches
+    void newGame();
+
+    // The start position, or the one in fen, with no earlier positions to repeat
+    void setPosition();
+    void setPosition(const std::string& fen);
+    // Plays a move the way the game loops do, so the search knows the position
+    // history. Returns false and leaves the position alone if text is not a
+    // legal move in coordinate notation.
+    bool playMove(const std::string& text);
+    void playMove(Move move);
+    Board& board() { return position; }
+
+    // Searches the position within limits, blocking until done. stop() and
+    // ponderHit() may be called from another thread meanwhile.
+    SearchResult search(const SearchLimits& limits);
+    // search() in two halves for a caller that searches on another thread.
+    // start() starts the stop flag and timer on the calling thread, so a
+    // stop() that comes before the search thread gets going is not lost.
+    void start(const SearchLimits& limits);
+    SearchResult run();
+
+    void stop() { control.stop(); }
+    // Gives a search started without a time limit one, see SearchControl
+    void ponderHit(int timeLimitMs) { control.ponderHit(timeLimitMs); }
+
+private:
+    Board position;
+    SearchControl control;
+    SearchLimits limits;
+    std::unique_ptr<TimeManager> timeManager;
+};
+
+#endif // SEARCHENGINE_H
@@ -0,0 +1,34 @@
+#include "searchstats.h"
+
+void writeSearchStatsJson(std::ostream& out, const std::vector<DepthStats>& iterations) {
+    out << "{\"iterations\": [";
+    uint64_t previousNodes = 0;
+    for (size_t i = 0; i < iterations.size(); i++) {
+        const DepthStats& stats = iterations[i];
+        const SearchStats& counters = stats.counters;
+        uint64_t nodes = stats.nodes;
+        double firstMoveCutoffRate = counters.betaCutoffs ? (double)counters.firstMoveCutoffs / counters.betaCutoffs : 0.0;
+        double branchingFactor = previousNodes ? (double)nodes / previousNodes : 0.0;
+        previousNodes = nodes;
+
+        out << (i > 0 ? ", " : "")
+            << "{\"depth\": " << stats.depth
+            << ", \"score\": " << stats.score
+            << ", \"bestmove\": \"" << moveToString(stats.bestMove) << "\""
+            << ", \"time_ms\": " << stats.elapsedMs
+            << ", \"nodes\": " << nodes
+            << ", \"main_nodes\": " << counters.nodes
+            << ", \"qnodes\": " << counters.qnodes
+            << ", \"tt_probes\": " << stats.ttProbes
+            << ", \"tt_hits\": " << stats.ttHits
+            << ", \"beta_cutoffs\": " << counters.betaCutoffs
+            << ", \"first_move_cutoff_rate\": " << firstMoveCutoffRate
+            << ", \"null_move_tries\": " << counters.nullMoveTries
+            << ", \"null_move_cutoffs\": " << counters.nullMoveCutoffs
+            << ", \"reduced_searches\": " << counters.reducedSearches
+            << ", \"re_searches\": " << counters.reSearches
+            << ", \"branching_factor\": " << branchingFactor
+            << "}";
+    }
+    out << "]}";
+}
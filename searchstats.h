@@ -0,0 +1,39 @@
+#pragma once
+#ifndef SEARCHSTATS_H
+#define SEARCHSTATS_H
+
+#include "chess.h"
+#include <ostream>
+#include <vector>
+
+// Search statistics for finding out why a search is slow. Build with
+// SEARCH_STATS defined to collect them: every node then bumps counters in
+// board.searchStats, and the main thread records a DepthStats for each
+// completed iteration in SearchResult::iterations. Without SEARCH_STATS the
+// counting compiles to nothing and iterations stays empty.
+#ifdef SEARCH_STATS
+#define SEARCH_STAT(board, counter) ((board).searchStats.counter++)
+#else
+#define SEARCH_STAT(board, counter) ((void)0)
+#endif
+
+// What one iteration of iterative deepening cost, aspiration re-searches
+// included
+struct DepthStats {
+    int depth = 0;
+    Score score = 0;
+    Move bestMove;
+    double elapsedMs = 0;
+    SearchStats counters;
+    uint64_t nodes = 0;     // Board::nodes, main search and quiescence nodes
+    uint64_t ttProbes = 0;
+    uint64_t ttHits = 0;
+};
+
+// One JSON object with a record per iteration, including the first move
+// cutoff rate and the effective branching factor (nodes of an iteration
+// over nodes of the one before). Both come from DepthStats::nodes, the count
+// SearchResult::nodes and the bench use. main_nodes and qnodes split it up.
+void writeSearchStatsJson(std::ostream& out, const std::vector<DepthStats>& iterations);
+
+#endif // SEARCHSTATS_H
@@ -0,0 +1,46 @@
+#include "timemanager.h"
+#include <algorithm>
+
+// Kept back from every move for the time it takes to pass the move on
+const int MOVE_OVERHEAD_MS = 20;
+// Moves the remaining time is split over when the clock does not say
+const int DEFAULT_MOVES_TO_GO = 30;
+// The hard limit is this many soft limits, but at most 4/5 of the clock
+// divided by the moves to go, counting at most 4
+const int HARD_LIMIT_FACTOR = 3;
+
+// Score drops since the previous iteration that buy more time
+const Score SCORE_DROP_SMALL = 30;
+const Score SCORE_DROP_LARGE = 80;
+
+TimeManager::TimeManager(int remainingMs, int incrementMs, int movesToGo)
+    : startTime(std::chrono::steady_clock::now()) {
+    int available = std::max(remainingMs - MOVE_OVERHEAD_MS, 1);
+    int moves = movesToGo > 0 ? std::min(movesToGo, DEFAULT_MOVES_TO_GO) : DEFAULT_MOVES_TO_GO;
+
+    softLimit = available / moves + incrementMs * 3 / 4;
+    hardLimit = std::max(std::min(softLimit * HARD_LIMIT_FACTOR, available * 4 / 5 / std::min(moves, 4)), 1);
+    softLimit = std::max(std::min(softLimit, hardLimit), 1);
+}
+
+bool TimeManager::stopAfterIteration(const Move& bestMove, Score score) {
+    stableIterations = (iterations > 0 && bestMove == lastBestMove) ? stableIterations + 1 : 0;
+
+    // 10% less time for every iteration the best move survived, down to half
+    double scale = 1.0 - 0.1 * std::min(stableIterations, 5);
+    if (iterations > 0 && !isMateScore(score) && !isMateScore(lastScore)) {
+        if (lastScore - score >= SCORE_DROP_LARGE) {
+            scale *= 2.0;
+        }
+        else if (lastScore - score >= SCORE_DROP_SMALL) {
+            scale *= 1.5;
+        }
+    }
+
+    lastBestMove = bestMove;
+    lastScore = score;
+    iterations++;
+
+    double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+    return elapsedMs * 2 >= softLimit * scale;
+}
@@ -0,0 +1,38 @@
+#pragma once
+#ifndef TIMEMANAGER_H
+#define TIMEMANAGER_H
+
+#include "chess.h"
+#include <chrono>
+
+// Turns the time left on the clock into a budget for one move. The hard limit
+// arms the SearchControl timer and is never exceeded. The soft limit is the
+// time the move should take: after each iteration the search stops if the
+// next iteration, which usually takes longer than all the earlier ones
+// together, would not finish within it. The soft limit shrinks while the best
+// move stays the same and grows when the score drops, so the time goes to the
+// moves that need it.
+class TimeManager {
+public:
+    // movesToGo of 0 means the rest of the game has to be played on remainingMs
+    TimeManager(int remainingMs, int incrementMs, int movesToGo);
+
+    int softLimitMs() const { return softLimit; }
+    int hardLimitMs() const { return hardLimit; }
+
+    // Called by the main thread after each completed iteration, returns true
+    // when the search should not start another one
+    bool stopAfterIteration(const Move& bestMove, Score score);
+
+private:
+    std::chrono::steady_clock::time_point startTime;
+    int softLimit;
+    int hardLimit;
+
+    Move lastBestMove;
+    Score lastScore = 0;
+    int iterations = 0;
+    int stableIterations = 0;   // Iterations in a row that kept the best move
+};
+
+#endif // TIMEMANAGER_H
@@ -1,18 +1,52 @@
 #include "chess.h"
 #include "engine.h"
 #include "engine2.h"
+#include "search.h"
+#include <cstdlib>
 #include <iostream>
 #include <string>
 
+// Book move or single-threaded search within limits
+static Move selfplayMove(Board& board, RootSearch search, const SearchLimits& limits) {
+    Move bookMove;
+    if (board.probeOpeningBook(bookMove)) {
+        return bookMove;
+    }
+    return lazySmpSearch(board, search, 1, limits).bestMove;
+}
+
+// Plays one game between the two engines and prints the winner. By default
+// every move searches a fixed number of nodes, so the same FEN and tables
+// always give the same game however loaded the machine is. --time switches
+// to the old wall-clock limit.
 int main(int argc, char** argv) {
     if (argc < 2) {
-        std::cerr << "Usage: " << argv[0] << " FEN [tablefile]" << std::endl;
+        std::cerr << "Usage: " << argv[0] << " FEN [tablefile] [--nodes N] [--depth D] [--time MS]" << std::endl;
         return 1;
     }
 
     std::string fen = argv[1];
-    if (argc >= 3) {
-        loadPieceSquareTables(argv[2]);
+    SearchLimits limits;
+    limits.nodes = 20000;
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        if ((arg == "--nodes" || arg == "--depth" || arg == "--time") && i + 1 < argc) {
+            long long value = std::atoll(argv[++i]);
+            if (arg == "--nodes") {
+                limits.nodes = (uint64_t)value;
+            }
+            else if (arg == "--depth") {
+                limits.depth = (int)value;
+                limits.nodes = 0;
+            }
+            else {
+                limits.timeMs = (int)value;
+                limits.nodes = 0;
+            }
+        }
+        else {
+            loadPieceSquareTables(arg);
+        }
     }
 
     initializeZobristTable();
@@ -20,7 +54,6 @@ int main(int argc, char** argv) {
     board.createBoardFromFEN(fen);
     board.configureTranspositionTableSize(32);
 
-    const int timeLimit = 50;  // milliseconds per move
     const int moveLimit = 100;
     bool engine1Turn = true;
     int moves = 0;
@@ -34,13 +67,12 @@ int main(int argc, char** argv) {
             }
             break;
         }
-        if (board.isThreefoldRepetition(false) || moves >= moveLimit) {
+        if (board.isThreefoldRepetition() || moves >= moveLimit) {
             std::cout << "draw" << std::endl;
             break;
         }
 
-        Move m = engine1Turn ? getEngineMove1(board, timeLimit)
-                              : getEngineMove2(board, timeLimit);
+        Move m = selfplayMove(board, engine1Turn ? engine : perft2, limits);
         board.makeMove(m);
         board.lastMove = m;
         board.updatePositionHistory(true);
@@ -50,4 +82,3 @@ int main(int argc, char** argv) {
 
     return 0;
 }
-
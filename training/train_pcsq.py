@@ -4,12 +4,18 @@ import random
 import re
 import subprocess
 import tempfile
+from concurrent.futures import ThreadPoolExecutor
+
+# Nodes searched per move. A node budget, unlike a time limit, makes every
+# game depend only on the tables, so scores are comparable across runs and
+# games can run in parallel without the machine load changing them.
+NODES_PER_MOVE = 20000
 
 
 def load_fens():
-    with open('Chess Engine.cpp', 'r') as f:
+    with open('positions.cpp', 'r') as f:
         text = f.read()
-    m = re.search(r"const char\* fenArray\[] = \{([^}]*)\};", text, re.S)
+    m = re.search(r"const char\* const fenArray\[] = \{([^}]*)\};", text, re.S)
     return re.findall(r"\"([^\"]+)\"", m.group(1)) if m else []
 
 
@@ -34,20 +40,25 @@ def load_default_tables():
     return tables
 
 
-def selfplay_score(tables, games=5):
+def play_game(fen, table_path):
+    res = subprocess.run(['./training/selfplay', fen, table_path,
+                          '--nodes', str(NODES_PER_MOVE)],
+                         capture_output=True, text=True)
+    return res.stdout.strip()
+
+
+def selfplay_score(tables, games=5, workers=os.cpu_count()):
     fens = load_fens()[:games]
     with tempfile.NamedTemporaryFile('w', delete=False) as f:
         json.dump(tables, f)
         temp_path = f.name
     score = 0
-    for fen in fens:
-        res = subprocess.run(['./training/selfplay', fen, temp_path],
-                             capture_output=True, text=True)
-        outcome = res.stdout.strip()
-        if outcome == 'engine1':
-            score += 1
-        elif outcome == 'engine2':
-            score -= 1
+    with ThreadPoolExecutor(max_workers=workers) as pool:
+        for outcome in pool.map(lambda fen: play_game(fen, temp_path), fens):
+            if outcome == 'engine1':
+                score += 1
+            elif outcome == 'engine2':
+                score -= 1
     os.remove(temp_path)
     return score
 
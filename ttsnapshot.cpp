@@ -0,0 +1,100 @@
+#include "ttsnapshot.h"
+#include "mappedfile.h"
+#include <cstring>
+#include <fstream>
+#include <type_traits>
+
+static_assert(std::is_trivially_copyable<TT_Entry>::value, "TT_Entry is written and read as raw bytes");
+
+static const char TT_SNAPSHOT_MAGIC[8] = { 'E', 'C', 'T', 'T', 'S', 'N', 'A', 'P' };
+
+// FNV-1a over 64-bit words with an extra shift to fold the high bits back
+// down. Word-at-a-time keeps checking a large table in the millisecond range.
+uint64_t ttSnapshotChecksum(const void* data, size_t size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+        uint64_t word;
+        std::memcpy(&word, bytes + i, sizeof(word));
+        hash = (hash ^ word) * 0x100000001b3ULL;
+        hash ^= hash >> 29;
+    }
+    for (; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+bool saveTranspositionTable(const std::string& filename, const Board& board, std::string& error) {
+    std::ofstream file(filename, std::ios::binary);
+    if (!file) {
+        error = "cannot open " + filename + " for writing";
+        return false;
+    }
+
+    const std::vector<TT_Entry>& entries = *board.transposition_table;
+    size_t bytes = entries.size() * sizeof(TT_Entry);
+
+    TTSnapshotHeader header;
+    std::memcpy(header.magic, TT_SNAPSHOT_MAGIC, sizeof(TT_SNAPSHOT_MAGIC));
+    header.version = TT_SNAPSHOT_VERSION;
+    header.entrySize = sizeof(TT_Entry);
+    header.entryCount = entries.size();
+    header.checksum = ttSnapshotChecksum(entries.data(), bytes);
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(entries.data()), bytes);
+    if (!file) {
+        error = "cannot write " + filename;
+        return false;
+    }
+    return true;
+}
+
+// Maps the snapshot, validates it and replaces the board's table with it. The
+// snapshot must be the size of the current table, so loading never changes
+// the size the user chose. On any failure the current table is left untouched.
+bool loadTranspositionTable(const std::string& filename, Board& board, std::string& error) {
+    MappedFile file;
+    if (!file.open(filename)) {
+        error = "cannot open " + filename;
+        return false;
+    }
+    if (file.size() < sizeof(TTSnapshotHeader)) {
+        error = filename + " is truncated";
+        return false;
+    }
+
+    TTSnapshotHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (std::memcmp(header.magic, TT_SNAPSHOT_MAGIC, sizeof(TT_SNAPSHOT_MAGIC)) != 0) {
+        error = filename + " is not a transposition table snapshot";
+        return false;
+    }
+    if (header.version != TT_SNAPSHOT_VERSION || header.entrySize != sizeof(TT_Entry)) {
+        error = filename + " has unsupported snapshot version " + std::to_string(header.version);
+        return false;
+    }
+    if (header.entryCount == 0 || (header.entryCount & (header.entryCount - 1)) != 0 ||
+        header.entryCount != (file.size() - sizeof(TTSnapshotHeader)) / sizeof(TT_Entry) ||
+        (file.size() - sizeof(TTSnapshotHeader)) % sizeof(TT_Entry) != 0) {
+        error = filename + " has the wrong size";
+        return false;
+    }
+    if (header.entryCount != board.transposition_table->size()) {
+        error = filename + " was saved with another Hash size, it holds " + std::to_string(header.entryCount)
+            + " entries and the table " + std::to_string(board.transposition_table->size());
+        return false;
+    }
+
+    const unsigned char* entries = file.data() + sizeof(TTSnapshotHeader);
+    size_t bytes = static_cast<size_t>(header.entryCount) * sizeof(TT_Entry);
+    if (ttSnapshotChecksum(entries, bytes) != header.checksum) {
+        error = filename + " fails its checksum";
+        return false;
+    }
+
+    std::memcpy(board.transposition_table->data(), entries, bytes);
+    return true;
+}
@@ -0,0 +1,29 @@
+#pragma once
+#ifndef TTSNAPSHOT_H
+#define TTSNAPSHOT_H
+
+#include "chess.h"
+#include <cstdint>
+#include <string>
+
+#define TT_SNAPSHOT_VERSION 3
+
+// On-disk layout of a transposition table snapshot: this header followed by the
+// raw TT_Entry array, so a snapshot can be mapped and copied in one go.
+struct TTSnapshotHeader {
+    char magic[8];          // "ECTTSNAP"
+    uint32_t version;       // TT_SNAPSHOT_VERSION
+    uint32_t entrySize;     // sizeof(TT_Entry) of the build that wrote it
+    uint64_t entryCount;    // Always a power of two
+    uint64_t checksum;      // ttSnapshotChecksum() of the entry array
+};
+static_assert(sizeof(TTSnapshotHeader) == 32, "TTSnapshotHeader must stay packed, it is mapped straight from disk");
+static_assert(sizeof(TTSnapshotHeader) % alignof(TT_Entry) == 0, "Entries must stay aligned when mapped");
+
+uint64_t ttSnapshotChecksum(const void* data, size_t size);
+// Both return false with the reason in error rather than printing it, the
+// caller knows where its messages go
+bool saveTranspositionTable(const std::string& filename, const Board& board, std::string& error);
+bool loadTranspositionTable(const std::string& filename, Board& board, std::string& error);
+
+#endif // TTSNAPSHOT_H
@@ -0,0 +1,380 @@
+#include "bench.h"
+#include "bitbase.h"
+#include "book.h"
+#include "chess.h"
+#include "engine.h"
+#include "engine2.h"
+#include "search.h"
+#include "searchengine.h"
+#include "ttsnapshot.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+
+// UCI front end. Commands are read on the main thread while the search runs on
+// a worker, so stop, ponderhit and isready are answered as the engine thinks.
+// The Engine with its table and move history lives as long as the process, so
+// a tournament manager can play any number of games with one engine process.
+
+namespace {
+
+const int DEFAULT_HASH_MB = 64;
+const int MAX_HASH_MB = 4096;
+const int MAX_THREADS = 256;
+const char* const DEFAULT_HASH_FILE = "hash.snap";
+
+// info and bestmove come from the worker, everything else from the main thread
+std::mutex outputMutex;
+
+void send(const std::string& line) {
+    std::lock_guard<std::mutex> lock(outputMutex);
+    std::cout << line << std::endl;
+}
+
+std::string lowercase(std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+    return text;
+}
+
+// "cp" from the side to move's point of view, or "mate" in moves, negative when being mated
+std::string uciScore(Score score) {
+    if (isMateScore(score)) {
+        int moves = score > 0 ? (SCORE_MATE - score + 1) / 2 : -(SCORE_MATE + score) / 2;
+        return "mate " + std::to_string(moves);
+    }
+    return "cp " + std::to_string(score);
+}
+
+class UciEngine {
+public:
+    UciEngine() : searchEngine(engine, DEFAULT_HASH_MB) {
+        searchEngine.onIteration = [this](const SearchResult& result) { info(result); };
+    }
+    ~UciEngine() { stopSearch(); }
+
+    // Answers commands from stdin until quit or the end of input
+    void run();
+
+private:
+    void uci();
+    void setOption(std::istringstream& args);
+    void newGame();
+    void position(std::istringstream& args);
+    void go(std::istringstream& args);
+    void ponderHit();
+    // Stops the search, if one is running, and waits for its bestmove
+    void stopSearch();
+    void search();
+    // An info line with the result so far, timed from the last go
+    void info(const SearchResult& result);
+
+    Engine searchEngine;
+    bool ownBook = false;
+    std::string hashFile = DEFAULT_HASH_FILE;
+
+    std::thread worker;
+    std::chrono::steady_clock::time_point searchStart;
+    SearchLimits ponderLimits;      // Of the running go ponder, used on ponderhit
+    std::mutex holdMutex;
+    std::condition_variable holdReleased;
+    // While pondering or on go infinite the bestmove has to wait for stop or
+    // ponderhit, even if the search ends by itself
+    bool holdBestMove = false;
+};
+
+void UciEngine::run() {
+    std::string line;
+    while (std::getline(std::cin, line)) {
+        std::istringstream args(line);
+        std::string command;
+        args >> command;
+
+        if (command == "uci") {
+            uci();
+        }
+        else if (command == "isready") {
+            send("readyok");
+        }
+        else if (command == "setoption") {
+            setOption(args);
+        }
+        else if (command == "ucinewgame") {
+            newGame();
+        }
+        else if (command == "position") {
+            position(args);
+        }
+        else if (command == "go") {
+            go(args);
+        }
+        else if (command == "stop") {
+            stopSearch();
+        }
+        else if (command == "ponderhit") {
+            ponderHit();
+        }
+        else if (command == "quit") {
+            break;
+        }
+        else if (!command.empty()) {
+            send("info string unknown command " + command);
+        }
+    }
+    stopSearch();
+}
+
+void UciEngine::uci() {
+    send("id name Chess Engine");
+    send("id author Chess Engine authors");
+    send("option name Hash type spin default " + std::to_string(DEFAULT_HASH_MB) + " min 1 max " + std::to_string(MAX_HASH_MB));
+    send("option name Threads type spin default 1 min 1 max " + std::to_string(MAX_THREADS));
+    send("option name Ponder type check default false");
+    send("option name OwnBook type check default false");
+    send("option name Evaluation type combo default engine1 var engine1 var engine2");
+    send(std::string("option name HashFile type string default ") + DEFAULT_HASH_FILE);
+    send("option name SaveHash type button");
+    send("option name LoadHash type button");
+    send("uciok");
+}
+
+// setoption name <name> [value <value>], option names are case insensitive
+void UciEngine::setOption(std::istringstream& args) {
+    std::string token, name, value;
+    args >> token;
+    while (args >> token && token != "value") {
+        name += (name.empty() ? "" : " ") + token;
+    }
+    while (args >> token) {
+        value += (value.empty() ? "" : " ") + token;
+    }
+    name = lowercase(name);
+
+    stopSearch();
+    if (name == "hash" && !value.empty()) {
+        searchEngine.setHashSize(std::min(std::max(std::atoi(value.c_str()), 1), MAX_HASH_MB));
+    }
+    else if (name == "threads" && !value.empty()) {
+        searchEngine.threads = std::min(std::max(std::atoi(value.c_str()), 1), MAX_THREADS);
+    }
+    else if (name == "ownbook") {
+        ownBook = lowercase(value) == "true";
+        if (ownBook && !searchEngine.board().openingBook) {
+            send(std::string("info string opening book ") + OPENING_BOOK_FILE + " not found");
+        }
+    }
+    else if (name == "evaluation") {
+        searchEngine.rootSearch = lowercase(value) == "engine2" ? perft2 : engine;
+    }
+    else if (name == "hashfile" && !value.empty()) {
+        hashFile = value;
+    }
+    // The table is saved and loaded as a whole, see ttsnapshot.h. A load keeps
+    // the current table if the file is missing, from another build or saved
+    // with a different Hash size.
+    else if (name == "savehash") {
+        std::string error;
+        if (!saveTranspositionTable(hashFile, searchEngine.board(), error)) {
+            send("info string could not save hash: " + error);
+        }
+    }
+    else if (name == "loadhash") {
+        std::string error;
+        if (!loadTranspositionTable(hashFile, searchEngine.board(), error)) {
+            send("info string could not load hash: " + error);
+        }
+    }
+    else if (name != "ponder") {
+        send("info string unknown option " + name);
+    }
+}
+
+// Nothing learned in one game carries over to the next
+void UciEngine::newGame() {
+    stopSearch();
+    searchEngine.newGame();
+}
+
+// position (startpos | fen <fen>) [moves <move>...]
+void UciEngine::position(std::istringstream& args) {
+    stopSearch();
+    std::string token, fen;
+    args >> token;
+    if (token == "startpos") {
+        searchEngine.setPosition();
+        args >> token;
+    }
+    else if (token == "fen") {
+        while (args >> token && token != "moves") {
+            fen += token + " ";
+        }
+        searchEngine.setPosition(fen);
+    }
+    else {
+        send("info string expected startpos or fen");
+        return;
+    }
+
+    while (args >> token) {
+        if (!searchEngine.playMove(token)) {
+            send("info string illegal move " + token);
+            break;
+        }
+    }
+}
+
+// go [wtime btime winc binc movestogo | movetime | depth | nodes | infinite] [ponder]
+void UciEngine::go(std::istringstream& args) {
+    stopSearch();
+
+    SearchLimits limits;
+    bool infinite = false;
+    bool ponder = false;
+    std::string token;
+    while (args >> token) {
+        long long value = 0;
+        if (token == "infinite") {
+            infinite = true;
+            continue;
+        }
+        if (token == "ponder") {
+            ponder = true;
+            continue;
+        }
+        if (!(args >> value)) {
+            break;
+        }
+        if (token == (searchEngine.board().whiteToMove ? "wtime" : "btime")) {
+            limits.remainingMs = std::max((int)value, 1);
+        }
+        else if (token == (searchEngine.board().whiteToMove ? "winc" : "binc")) {
+            limits.incrementMs = (int)value;
+        }
+        else if (token == "movestogo") {
+            limits.movesToGo = (int)value;
+        }
+        else if (token == "movetime") {
+            limits.timeMs = (int)value;
+        }
+        else if (token == "depth") {
+            limits.depth = (int)std::min(std::max(value, 1LL), (long long)MAX_DEPTH);
+        }
+        else if (token == "nodes") {
+            limits.nodes = (uint64_t)value;
+        }
+    }
+
+    Move bookMove;
+    if (ownBook && !ponder && !infinite && searchEngine.board().probeOpeningBook(bookMove)) {
+        send("bestmove " + moveToString(bookMove));
+        return;
+    }
+
+    // The search is started here rather than on the worker, so a stop that
+    // comes before the worker gets going cannot be undone by it. A ponder or
+    // infinite search runs without a time limit, ponderhit gives it one.
+    ponderLimits = limits;
+    if (ponder || infinite) {
+        limits.timeMs = 0;
+        limits.remainingMs = 0;
+    }
+    searchStart = std::chrono::steady_clock::now();
+    searchEngine.start(limits);
+    holdBestMove = ponder || infinite;
+    worker = std::thread([this]() { search(); });
+}
+
+// The ponder search becomes the real one and gets the time the limits of its
+// go command allow, the soft limit when on a clock, counted from now
+void UciEngine::ponderHit() {
+    if (!worker.joinable()) {
+        return;
+    }
+    int timeLimitMs = ponderLimits.remainingMs > 0
+        ? TimeManager(ponderLimits.remainingMs, ponderLimits.incrementMs, ponderLimits.movesToGo).softLimitMs()
+        : ponderLimits.timeMs;
+    searchEngine.ponderHit(timeLimitMs);
+    {
+        std::lock_guard<std::mutex> lock(holdMutex);
+        holdBestMove = false;
+    }
+    holdReleased.notify_one();
+}
+
+void UciEngine::stopSearch() {
+    if (!worker.joinable()) {
+        return;
+    }
+    searchEngine.stop();
+    {
+        std::lock_guard<std::mutex> lock(holdMutex);
+        holdBestMove = false;
+    }
+    holdReleased.notify_one();
+    worker.join();
+}
+
+// The final result is reported once more, with the nodes of every thread and
+// the move of an iteration that was stopped but already beat the last one
+void UciEngine::search() {
+    SearchResult result = searchEngine.run();
+    {
+        std::unique_lock<std::mutex> lock(holdMutex);
+        holdReleased.wait(lock, [this]() { return !holdBestMove; });
+    }
+    info(result);
+
+    std::string bestMove = "bestmove " + moveToString(result.bestMove);
+    if (result.bestMove.from != -1 && result.ponderMove.from != -1) {
+        bestMove += " ponder " + moveToString(result.ponderMove);
+    }
+    send(bestMove);
+}
+
+void UciEngine::info(const SearchResult& result) {
+    uint64_t elapsedMs = (uint64_t)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - searchStart).count();
+    std::ostringstream line;
+    line << "info depth " << result.depth << " score " << uciScore(result.score)
+        << " nodes " << result.nodes << " nps " << (elapsedMs > 0 ? result.nodes * 1000 / elapsedMs : 0)
+        << " time " << elapsedMs << " hashfull " << searchEngine.board().hashfull();
+    if (result.bestMove.from != -1) {
+        line << " pv " << moveToString(result.bestMove);
+        if (result.ponderMove.from != -1) {
+            line << " " << moveToString(result.ponderMove);
+        }
+    }
+    send(line.str());
+}
+
+}
+
+// "uci bench [depth] [hashMb] [jsonfile]" runs the same benchmark as the GUI
+int main(int argc, char** argv) {
+    if (argc > 1 && std::string(argv[1]) == "bench") {
+        BenchOptions options;
+        if (argc > 2) {
+            options.depth = std::stoi(argv[2]);
+        }
+        if (argc > 3) {
+            options.hashMb = std::stoi(argv[3]);
+        }
+        if (argc > 4) {
+            options.jsonPath = argv[4];
+        }
+        runBench(options);
+        return 0;
+    }
+
+    initializeZobristTable();
+    initializeBitbases();
+    UciEngine uciEngine;
+    uciEngine.run();
+    return 0;
+}
@@ -3,6 +3,7 @@
 #include "iostream"
 #include <array>
 #include <vector>
+#include <mutex>
 #include <unordered_set>
 #include <random>
 
@@ -28,7 +29,7 @@ std::vector<uint64_t> generateRandomNumbers(size_t count, uint64_t seed)
 }
 
 
-void initializeZobristTable() {
+static void fillZobristTable() {
     // Generate random numbers
     const size_t totalNumbers = 64 * 12 + 1 + 6 + 8;  // all pieces + moves , whitetomove, castling, en passant column
     auto randomNumbers = generateRandomNumbers(totalNumbers, 5259408);
@@ -52,4 +53,11 @@ void initializeZobristTable() {
 
     zobristSideToMove = randomNumbers[j];
     j += 1;
+}
+
+void initializeZobristTable() {
+    // Every Board calls this, from whatever thread creates it, but the keys
+    // are only written the first time
+    static std::once_flag initialized;
+    std::call_once(initialized, fillZobristTable);
 }
\ No newline at end of file